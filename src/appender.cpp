@@ -0,0 +1,69 @@
+#include "appender.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+appender::appender(hid_t dataset, hid_t mem_type)
+: dataset_(dataset), mem_type_(mem_type), size_(0), min_growth_(1)
+{
+    file_space_ = H5Dget_space(dataset_);
+    H5Sget_simple_extent_dims(file_space_, &capacity_, NULL);
+
+    // grow by at least a chunk at a time
+    auto dcpl = H5Dget_create_plist(dataset_);
+    if (H5Pget_layout(dcpl) == H5D_CHUNKED)
+        H5Pget_chunk(dcpl, 1, &min_growth_);
+    H5Pclose(dcpl);
+
+    hsize_t one = 1;
+    mem_space_ = H5Screate_simple(1, &one, NULL);
+}
+
+appender::~appender()
+{
+    close();
+}
+
+hsize_t appender::grow(hsize_t count)
+{
+    auto start = size_;
+    if (size_ + count > capacity_)
+    {
+        capacity_ = max({size_ + count, 2 * capacity_, min_growth_});
+        H5Dset_extent(dataset_, &capacity_);
+        H5Sset_extent_simple(file_space_, 1, &capacity_, NULL);  // instead of H5Dget_space
+    }
+    size_ += count;
+    return start;
+}
+
+void appender::append(const void* buf, hsize_t count)
+{
+    write_batch batch;
+    append(buf, count, batch);
+    batch.flush();
+}
+
+void appender::append(const void* buf, hsize_t count, write_batch& batch)
+{
+    if (count == 0)
+        return;
+
+    hsize_t start = grow(count);
+    H5Sselect_hyperslab(file_space_, H5S_SELECT_SET, &start, NULL, &count, NULL);
+    H5Sset_extent_simple(mem_space_, 1, &count, NULL);  // selects all of the memory buffer
+    batch.add(dataset_, mem_type_, mem_space_, file_space_, buf);
+}
+
+void appender::close()
+{
+    if (file_space_ < 0)
+        return;
+
+    if (capacity_ != size_)
+        H5Dset_extent(dataset_, &size_);
+    H5Sclose(mem_space_);
+    H5Sclose(file_space_);
+    file_space_ = mem_space_ = H5I_INVALID_HID;
+}
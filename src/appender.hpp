@@ -0,0 +1,50 @@
+#ifndef APPENDER_HPP
+#define APPENDER_HPP
+
+#include "hdf5.h"
+#include "write_batch.hpp"
+
+// Appends elements to a one-dimensional dataset
+//
+// The extent is tracked in memory and, when it must grow, it grows
+// geometrically, so a long run of small appends makes only a few calls to
+// H5Dset_extent. The file and memory dataspaces are created once and reused.
+// `close` trims the extent to the elements actually appended.
+class appender
+{
+public:
+    // Appends to `dataset`, starting at element 0, from memory of type `mem_type`
+    appender(hid_t dataset, hid_t mem_type);
+    ~appender();
+
+    appender(const appender&) = delete;
+    appender& operator=(const appender&) = delete;
+
+    // Writes `count` elements from `buf` after the last appended element
+    void append(const void* buf, hsize_t count);
+
+    // Same as above, but queues the write in `batch`, e.g., to write several
+    // datasets with one call
+    void append(const void* buf, hsize_t count, write_batch& batch);
+
+    // Makes room for `count` more elements without writing them (e.g., for
+    // H5Dwrite_chunk) and returns the offset of the first one
+    hsize_t grow(hsize_t count);
+
+    // The number of elements appended so far
+    hsize_t size() const { return size_; }
+
+    // Sets the final extent and releases the dataspaces
+    void close();
+
+private:
+    hid_t   dataset_;
+    hid_t   mem_type_;
+    hid_t   file_space_;
+    hid_t   mem_space_;
+    hsize_t size_;
+    hsize_t capacity_;
+    hsize_t min_growth_;
+};
+
+#endif
@@ -0,0 +1,57 @@
+#include "attribute_batch.hpp"
+
+using namespace std;
+
+void attribute_batch::add(const string& name, const string& key, const string& value)
+{
+    attributes_.push_back({name.empty() ? "." : name, key, true, value, 0.0});
+}
+
+void attribute_batch::add(const string& name, const string& key, const double& value)
+{
+    attributes_.push_back({name.empty() ? "." : name, key, false, "", value});
+}
+
+void attribute_batch::write(hid_t loc) const
+{
+    auto scalar = H5Screate(H5S_SCALAR);
+    auto acpl = H5Pcreate(H5P_ATTRIBUTE_CREATE);
+    H5Pset_char_encoding(acpl, H5T_CSET_UTF8);
+
+    // Open each object once, however many attributes it gets
+    string open_name;
+    hid_t obj = H5I_INVALID_HID;
+    for (auto& a : attributes_)
+    {
+        if (obj == H5I_INVALID_HID || a.name != open_name)
+        {
+            if (obj != H5I_INVALID_HID)
+                H5Oclose(obj);
+            obj = H5Oopen(loc, a.name.c_str(), H5P_DEFAULT);
+            open_name = a.name;
+        }
+
+        if (a.is_string)
+        {
+            // the same type as `add_docstring`
+            auto strtype = H5Tcopy(H5T_C_S1);
+            H5Tset_size(strtype, a.text.size());
+            H5Tset_strpad(strtype, H5T_STR_NULLTERM);
+            auto attr = H5Acreate(obj, a.key.c_str(), strtype, scalar, H5P_DEFAULT, H5P_DEFAULT);
+            H5Awrite(attr, strtype, a.text.c_str());
+            H5Aclose(attr);
+            H5Tclose(strtype);
+        }
+        else
+        {
+            auto attr = H5Acreate(obj, a.key.c_str(), H5T_NATIVE_DOUBLE, scalar, acpl, H5P_DEFAULT);
+            H5Awrite(attr, H5T_NATIVE_DOUBLE, &a.number);
+            H5Aclose(attr);
+        }
+    }
+    if (obj != H5I_INVALID_HID)
+        H5Oclose(obj);
+
+    H5Pclose(acpl);
+    H5Sclose(scalar);
+}
@@ -0,0 +1,42 @@
+#ifndef ATTRIBUTE_BATCH_HPP
+#define ATTRIBUTE_BATCH_HPP
+
+#include "hdf5.h"
+#include <string>
+#include <vector>
+
+// Collects the attributes of a file and creates them in one pass
+//
+// In an MPI run, creating an attribute is a collective metadata operation:
+// every rank makes the same calls with the same values. Collecting them first
+// opens each object once (instead of one path lookup per attribute) and
+// creates all attributes back to back, so that they end up together in the
+// metadata cache and are flushed in a few large writes when the file closes.
+class attribute_batch
+{
+public:
+    // Adds a scalar string attribute `key` to the object `name` ("." = root group)
+    void add(const std::string& name, const std::string& key, const std::string& value);
+
+    // Adds a scalar double attribute `key` (which may be any UTF-8 name) to `name`
+    void add(const std::string& name, const std::string& key, const double& value);
+
+    // Creates all attributes in `loc`, in the order in which they were added
+    void write(hid_t loc) const;
+
+    std::size_t size() const { return attributes_.size(); }
+
+private:
+    struct attribute
+    {
+        std::string name;
+        std::string key;
+        bool        is_string;
+        std::string text;
+        double      number;
+    };
+
+    std::vector<attribute> attributes_;
+};
+
+#endif
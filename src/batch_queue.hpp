@@ -0,0 +1,80 @@
+#ifndef BATCH_QUEUE_HPP
+#define BATCH_QUEUE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+// A bounded, blocking FIFO that hands work from one thread to another
+//
+// `push` blocks while the queue is full and `pop` while it is empty, and both
+// add the time they spent blocked to `waited()`, so the two ends can tell
+// which side of a producer/consumer pipeline is the bottleneck.
+template <class T>
+class batch_queue
+{
+public:
+    explicit batch_queue(size_t capacity) : capacity_(capacity) {}
+
+    void push(T item)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wait(lock, not_full_, [this] { return items_.size() < capacity_; });
+        items_.push_back(std::move(item));
+        lock.unlock();
+        not_empty_.notify_one();
+    }
+
+    // Returns false once the queue is closed and drained
+    bool pop(T& item)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wait(lock, not_empty_, [this] { return closed_ || !items_.empty(); });
+        if (items_.empty())
+            return false;
+        item = std::move(items_.front());
+        items_.pop_front();
+        lock.unlock();
+        not_full_.notify_one();
+        return true;
+    }
+
+    // No more pushes; wakes up everyone waiting in `pop`
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_empty_.notify_all();
+    }
+
+    std::chrono::duration<double> waited() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return waited_;
+    }
+
+private:
+    template <class Predicate>
+    void wait(std::unique_lock<std::mutex>& lock, std::condition_variable& cv, Predicate ready)
+    {
+        if (ready())
+            return;
+        auto t = std::chrono::steady_clock::now();
+        cv.wait(lock, ready);
+        waited_ += std::chrono::steady_clock::now() - t;
+    }
+
+    size_t                         capacity_;
+    std::deque<T>                  items_;
+    bool                           closed_ = false;
+    std::chrono::duration<double>  waited_{0};
+    mutable std::mutex             mutex_;
+    std::condition_variable        not_empty_;
+    std::condition_variable        not_full_;
+};
+
+#endif
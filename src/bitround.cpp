@@ -0,0 +1,39 @@
+#include "bitround.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+int bitround_keepbits(const double& error_bound)
+{
+    // Rounding to k bits changes a value by at most 2^-(k+1) of its magnitude
+    int keepbits = (int)ceil(-log2(error_bound)) - 1;
+    return (keepbits < 0) ? 0 : (keepbits > 52) ? 52 : keepbits;
+}
+
+void bitround(double* data, const size_t& count, const int& keepbits)
+{
+    if (keepbits >= 52)
+        return;
+
+    const int drop = 52 - keepbits;
+    const uint64_t half = (uint64_t)1 << (drop - 1), mask = ~(((uint64_t)1 << drop) - 1);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint64_t bits;
+        memcpy(&bits, &data[i], sizeof(bits));
+        bits += half - 1 + ((bits >> drop) & 1);  // a carry into the exponent is correct rounding
+        bits &= mask;
+        memcpy(&data[i], &bits, sizeof(bits));
+    }
+}
+
+int scaleoffset_digits(const double& error_bound)
+{
+    // Scaling by 10^D and truncating to integers changes a value by less than 10^-D
+    int digits = (int)ceil(-log10(error_bound));
+    return (digits < 0) ? 0 : digits;
+}
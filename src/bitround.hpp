@@ -0,0 +1,17 @@
+#ifndef BITROUND_HPP
+#define BITROUND_HPP
+
+#include <cstddef>
+
+// The number of mantissa bits to keep for a relative error of at most `error_bound`
+extern int bitround_keepbits(const double& error_bound);
+
+// Rounds the mantissas of `count` doubles at `data` to `keepbits` bits (to nearest,
+// ties to even). The zeroed low bits compress well after shuffle+deflate.
+extern void bitround(double* data, const size_t& count, const int& keepbits);
+
+// The decimal scale factor for HDF5's scale-offset filter for an absolute error
+// of at most `error_bound`
+extern int scaleoffset_digits(const double& error_bound);
+
+#endif
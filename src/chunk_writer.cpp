@@ -0,0 +1,106 @@
+#include "chunk_writer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <zlib.h>
+
+using namespace std;
+
+namespace
+{
+    // Byte shuffle, as HDF5's H5Z_FILTER_SHUFFLE: byte k of every element, for k = 0, 1, ...
+    void shuffle_bytes(const unsigned char* in, unsigned char* out, size_t count, size_t elem_size)
+    {
+        for (size_t k = 0; k < elem_size; ++k)
+            for (size_t i = 0; i < count; ++i)
+                out[k * count + i] = in[i * elem_size + k];
+    }
+
+    // Runs the filter pipeline on one chunk
+    void pack(const vector<double>& raw, vector<unsigned char>& packed, bool shuffle, int deflate)
+    {
+        auto bytes = raw.size() * sizeof(double);
+        vector<unsigned char> shuffled;
+        auto in = (const unsigned char*)raw.data();
+        if (shuffle)
+        {
+            shuffled.resize(bytes);
+            shuffle_bytes(in, shuffled.data(), raw.size(), sizeof(double));
+            in = shuffled.data();
+        }
+
+        if (deflate > 0)
+        {
+            // HDF5's deflate filter stores a zlib stream, as compress2 makes it
+            auto size = compressBound(bytes);
+            packed.resize(size);
+            if (compress2(packed.data(), &size, in, bytes, deflate) != Z_OK)
+                throw runtime_error("compress2 failed");
+            packed.resize(size);
+        }
+        else
+        {
+            packed.assign(in, in + bytes);
+        }
+    }
+}
+
+chunk_writer::chunk_writer(hid_t dataset, size_t chunk_size, bool shuffle, int deflate, thread_pool& pool)
+: dataset_(dataset), chunk_size_(chunk_size), shuffle_(shuffle), deflate_(deflate), pool_(pool)
+{
+    staging_.reserve(chunk_size_);
+}
+
+void chunk_writer::append(const double* data, size_t count)
+{
+    while (count > 0)
+    {
+        auto n = min(count, chunk_size_ - staging_.size());
+        staging_.insert(staging_.end(), data, data + n);
+        data += n;
+        count -= n;
+        if (staging_.size() == chunk_size_)
+            submit();
+    }
+
+    // Write what is done, and bound the number of chunks in flight
+    while (!pending_.empty() &&
+           (pending_.front()->done.wait_for(chrono::seconds(0)) == future_status::ready ||
+            pending_.size() > 2 * pool_.size()))
+        write_front();
+}
+
+void chunk_writer::close()
+{
+    if (!staging_.empty())
+    {
+        staging_.resize(chunk_size_, 0.0);  // chunks are stored whole; the extent hides the padding
+        submit();
+    }
+    while (!pending_.empty())
+        write_front();
+}
+
+void chunk_writer::submit()
+{
+    auto c = make_unique<chunk>();
+    c->offset = next_offset_;
+    c->raw.swap(staging_);
+    staging_.reserve(chunk_size_);
+    next_offset_ += chunk_size_;
+
+    auto job = c.get();
+    c->done = pool_.submit([job, this] { pack(job->raw, job->packed, shuffle_, deflate_); });
+    pending_.push_back(move(c));
+}
+
+void chunk_writer::write_front()
+{
+    auto& c = *pending_.front();
+    c.done.get();
+    hsize_t offset[] = {c.offset};
+    // filter mask 0: all filters of the pipeline were applied
+    H5Dwrite_chunk(dataset_, H5P_DEFAULT, 0, offset, c.packed.size(), c.packed.data());
+    pending_.pop_front();
+}
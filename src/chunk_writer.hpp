@@ -0,0 +1,51 @@
+#ifndef CHUNK_WRITER_HPP
+#define CHUNK_WRITER_HPP
+
+#include "thread_pool.hpp"
+
+#include "hdf5.h"
+#include <deque>
+#include <future>
+#include <memory>
+#include <vector>
+
+// Appends doubles to a one-dimensional, chunked dataset whose filter pipeline
+// is (optionally) shuffle followed by (optionally) deflate
+//
+// Full chunks are compressed on a thread pool and written in order with
+// H5Dwrite_chunk, bypassing HDF5's serial filter pipeline. The result is an
+// ordinary filtered dataset that any HDF5 reader can read.
+class chunk_writer
+{
+public:
+    chunk_writer(hid_t dataset, size_t chunk_size, bool shuffle, int deflate, thread_pool& pool);
+
+    // Appends `count` values; the caller must have extended the dataset to cover them
+    void append(const double* data, size_t count);
+
+    // Writes the last (partial) chunk and waits for all chunks to be written
+    void close();
+
+private:
+    struct chunk
+    {
+        hsize_t                    offset;
+        std::vector<double>        raw;
+        std::vector<unsigned char> packed;
+        std::future<void>          done;
+    };
+
+    void submit();
+    void write_front();
+
+    hid_t                               dataset_;
+    size_t                              chunk_size_;
+    bool                                shuffle_;
+    int                                 deflate_;
+    thread_pool&                        pool_;
+    std::vector<double>                 staging_;
+    hsize_t                             next_offset_ = 0;
+    std::deque<std::unique_ptr<chunk>>  pending_;
+};
+
+#endif
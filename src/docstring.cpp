@@ -1,4 +1,5 @@
 #include "docstring.hpp"
+#include <vector>
 
 using namespace std;
 
@@ -14,3 +15,38 @@ void add_docstring(hid_t& loc, const string& name, const string& key, const stri
     H5Tclose(strtype);
     H5Sclose(scalar);
 }
+
+string get_docstring(hid_t& loc, const string& name, const string& key)
+{
+    const char* obj = (name.size() >= 1) ? name.c_str() : ".";
+    if (H5Aexists_by_name(loc, obj, key.c_str(), H5P_DEFAULT) <= 0)
+        return "";
+
+    hid_t attr = H5Aopen_by_name(loc, obj, key.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+    hid_t ftype = H5Aget_type(attr), strtype = H5Tcopy(H5T_C_S1);
+    string value(H5Tget_size(ftype), '\0');
+    H5Tset_size(strtype, value.size() + 1);
+    H5Tset_strpad(strtype, H5T_STR_NULLTERM);
+    vector<char> buf(value.size() + 1);
+    H5Aread(attr, strtype, buf.data());
+    value = buf.data();
+    H5Tclose(strtype);
+    H5Tclose(ftype);
+    H5Aclose(attr);
+    return value;
+}
+
+void add_rng_docstrings(hid_t& loc, const string& name, const uint64_t& seed, const uint32_t& stream, const size_t& first_path)
+{
+    attribute_batch batch;
+    add_rng_docstrings(batch, name, seed, stream, first_path);
+    batch.write(loc);
+}
+
+void add_rng_docstrings(attribute_batch& batch, const string& name, const uint64_t& seed, const uint32_t& stream, const size_t& first_path)
+{
+    batch.add(name, "generator", string("Philox4x32-10 and Box-Muller, one stream per path"));
+    batch.add(name, "seed", to_string(seed));
+    batch.add(name, "stream", to_string(stream));
+    batch.add(name, "first_path", to_string(first_path));
+}
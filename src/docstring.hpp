@@ -1,7 +1,9 @@
 #ifndef DOCSTRING_HPP
 #define DOCSTRING_HPP
 
+#include "attribute_batch.hpp"
 #include "hdf5.h"
+#include <cstdint>
 #include <string>
 
 // Writes a scalar HDF5 string attribute
@@ -13,4 +15,33 @@ extern void add_docstring
     const std::string& value
 );
 
+// Reads a scalar HDF5 string attribute ("" if there is none)
+extern std::string get_docstring
+(
+    hid_t&             loc,
+    const std::string& name,
+    const std::string& key
+);
+
+// Records the random stream of the sample paths in `name` as string attributes,
+// so that the paths can be regenerated instead of read
+extern void add_rng_docstrings
+(
+    hid_t&             loc,
+    const std::string& name,
+    const uint64_t&    seed,
+    const uint32_t&    stream,
+    const size_t&      first_path
+);
+
+// Same as above, but adds the attributes to `batch`
+extern void add_rng_docstrings
+(
+    attribute_batch&   batch,
+    const std::string& name,
+    const uint64_t&    seed,
+    const uint32_t&    stream,
+    const size_t&      first_path
+);
+
 #endif
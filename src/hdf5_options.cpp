@@ -0,0 +1,176 @@
+#include "hdf5_options.hpp"
+#include "bitround.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+using namespace std;
+
+void set_hdf5_options(argparse::ArgumentParser& program)
+{
+    program.add_argument("-b", "--block")
+    .help("chooses the number of paths generated and written at a time (0 = about 64 MiB)")
+    .default_value(size_t{0})
+    .scan<'u', size_t>();
+
+    program.add_argument("-j", "--threads")
+    .help("chooses the number of sampler threads (0 = one per hardware thread)")
+    .default_value(size_t{0})
+    .scan<'u', size_t>();
+
+    program.add_argument("--chunk")
+    .help("chooses a chunked layout: path, time, or <rows>x<columns> (default: contiguous)")
+    .default_value(string{});
+
+    program.add_argument("--shuffle")
+    .help("shuffles the bytes of each chunk before compression")
+    .default_value(false)
+    .implicit_value(true);
+
+    program.add_argument("--deflate")
+    .help("chooses the gzip compression level, 1-9 (default: no compression)")
+    .default_value(0)
+    .scan<'i', int>();
+
+    program.add_argument("--fletcher32")
+    .help("adds a Fletcher32 checksum to each chunk")
+    .default_value(false)
+    .implicit_value(true);
+
+    program.add_argument("--lossy")
+    .help("chooses lossy compression: bitround (relative error) or scaleoffset (absolute error)")
+    .default_value(string{});
+
+    program.add_argument("--error")
+    .help("chooses the error bound of lossy compression")
+    .default_value(double{1e-6})
+    .scan<'g', double>();
+}
+
+int get_hdf5_options(const argparse::ArgumentParser& program, hdf5_options& options)
+{
+    options.block_rows = program.get<size_t>("--block");
+    options.thread_count = program.get<size_t>("--threads");
+
+    options.chunk = program.get<string>("--chunk");
+    if (!options.chunk.empty() && options.chunk != "path" && options.chunk != "time")
+    {
+        size_t rows = 0, columns = 0;
+        if (sscanf(options.chunk.c_str(), "%zux%zu", &rows, &columns) != 2 || rows == 0 || columns == 0) {
+            cerr << "Chunk shape must be path, time, or <rows>x<columns>" << endl;
+            return -1;
+        }
+    }
+    options.shuffle = program.get<bool>("--shuffle");
+    options.deflate = program.get<int>("--deflate");
+    if (options.deflate < 0 || options.deflate > 9) {
+        cerr << "Deflate level must be between 0 (no compression) and 9" << endl;
+        return -1;
+    }
+    options.fletcher32 = program.get<bool>("--fletcher32");
+
+    options.lossy = program.get<string>("--lossy");
+    if (!options.lossy.empty() && options.lossy != "bitround" && options.lossy != "scaleoffset") {
+        cerr << "Lossy compression must be bitround or scaleoffset" << endl;
+        return -1;
+    }
+    options.error_bound = program.get<double>("--error");
+    if (!(options.error_bound > 0.0)) {
+        cerr << "Error bound must be greater than zero" << endl;
+        return -1;
+    }
+    // lossy modes only pay off when followed by shuffle+deflate
+    if (!options.lossy.empty() && options.deflate == 0 && !program.is_used("--deflate"))
+    {
+        options.shuffle = true;
+        options.deflate = 4;
+    }
+    if (options.lossy == "scaleoffset" && H5Zfilter_avail(H5Z_FILTER_SCALEOFFSET) <= 0) {
+        cerr << "This HDF5 library has no scale-offset filter" << endl;
+        return -1;
+    }
+
+    // filters only apply to chunked datasets
+    if (options.chunk.empty() && (options.shuffle || options.deflate > 0 || options.fletcher32 || !options.lossy.empty()))
+        options.chunk = "path";
+
+    if (options.deflate > 0 && H5Zfilter_avail(H5Z_FILTER_DEFLATE) <= 0) {
+        cerr << "This HDF5 library has no deflate filter" << endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+void chunk_shape(const hdf5_options& options, const size_t& path_count, const size_t& step_count, hsize_t chunk[2])
+{
+    const hsize_t target = 128 * 1024;  // elements, i.e., 1 MiB per chunk
+
+    if (options.chunk.empty())
+    {
+        chunk[0] = chunk[1] = 0;
+    }
+    else if (options.chunk == "path")
+    {
+        chunk[1] = min<hsize_t>(step_count, target);
+        chunk[0] = max<hsize_t>(1, target / chunk[1]);
+    }
+    else if (options.chunk == "time")
+    {
+        chunk[0] = min<hsize_t>(path_count, 1024);
+        chunk[1] = max<hsize_t>(1, target / chunk[0]);
+    }
+    else
+    {
+        size_t rows, columns;
+        sscanf(options.chunk.c_str(), "%zux%zu", &rows, &columns);
+        chunk[0] = rows;
+        chunk[1] = columns;
+    }
+
+    // chunks may not be larger than a fixed-size dataset
+    if (chunk[0] > 0)
+    {
+        chunk[0] = min<hsize_t>(chunk[0], path_count);
+        chunk[1] = min<hsize_t>(chunk[1], step_count);
+    }
+}
+
+hid_t make_dcpl(const hdf5_options& options, const size_t& path_count, const size_t& step_count)
+{
+    auto dcpl = H5Pcreate(H5P_DATASET_CREATE);
+
+    hsize_t chunk[2];
+    chunk_shape(options, path_count, step_count, chunk);
+    if (chunk[0] == 0)
+        return dcpl;
+
+    H5Pset_chunk(dcpl, 2, chunk);
+    // the filters run in the order in which they are added
+    if (options.lossy == "scaleoffset")
+        H5Pset_scaleoffset(dcpl, H5Z_SO_FLOAT_DSCALE, scaleoffset_digits(options.error_bound));
+    if (options.shuffle)
+        H5Pset_shuffle(dcpl);
+    if (options.deflate > 0)
+        H5Pset_deflate(dcpl, options.deflate);
+    if (options.fletcher32)
+        H5Pset_fletcher32(dcpl);
+
+    return dcpl;
+}
+
+void add_lossy_attributes(hid_t& loc, const string& name, const hdf5_options& options)
+{
+    attribute_batch batch;
+    add_lossy_attributes(batch, name, options);
+    batch.write(loc);
+}
+
+void add_lossy_attributes(attribute_batch& batch, const string& name, const hdf5_options& options)
+{
+    if (options.lossy.empty())
+        return;
+
+    batch.add(name, "lossy", string(options.lossy == "bitround" ? "bitround, relative error" : "scaleoffset, absolute error"));
+    batch.add(name, "error_bound", options.error_bound);
+}
@@ -0,0 +1,51 @@
+#ifndef HDF5_OPTIONS_HPP
+#define HDF5_OPTIONS_HPP
+
+#include "argparse.hpp"
+#include "attribute_batch.hpp"
+#include "hdf5.h"
+#include <string>
+
+// How `ou_hdf5` generates and writes `/dataset`
+struct hdf5_options
+{
+    size_t      block_rows;    // paths per generated and written block (0 = automatic)
+    size_t      thread_count;  // sampler threads (0 = one per hardware thread)
+    std::string chunk;         // "" (contiguous), "path", "time", or "<rows>x<columns>"
+    bool        shuffle;       // byte shuffle before compression
+    int         deflate;       // gzip level 1-9 (0 = no deflate)
+    bool        fletcher32;    // checksum every chunk
+    std::string lossy;         // "" (lossless), "bitround", or "scaleoffset"
+    double      error_bound;   // relative (bitround) or absolute (scaleoffset) error bound
+};
+
+// Sets the options for which we are looking
+extern void set_hdf5_options(argparse::ArgumentParser& program);
+
+// Tests the options and retrieves the arguments
+extern int get_hdf5_options(const argparse::ArgumentParser& program, hdf5_options& options);
+
+// The chunk shape for a `path_count` x `step_count` dataset, {0, 0} if contiguous
+//
+// "path" tiles hold (parts of) whole paths and favor reading paths, "time"
+// tiles hold many paths over a short time and favor reading time slices.
+extern void chunk_shape
+(
+    const hdf5_options& options,
+    const size_t&       path_count,
+    const size_t&       step_count,
+    hsize_t             chunk[2]
+);
+
+// Creates the dataset creation property list with the chosen layout and filters
+//
+// Bit-rounding is not a filter; the writer must apply `bitround` to the data.
+extern hid_t make_dcpl(const hdf5_options& options, const size_t& path_count, const size_t& step_count);
+
+// Records the lossy compression mode and its error bound as attributes of `name`
+extern void add_lossy_attributes(hid_t& loc, const std::string& name, const hdf5_options& options);
+
+// Same as above, but adds the attributes to `batch`
+extern void add_lossy_attributes(attribute_batch& batch, const std::string& name, const hdf5_options& options);
+
+#endif
@@ -0,0 +1,160 @@
+#include "hsds_client.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+using namespace std;
+
+double percentile(vector<double> values, double q)
+{
+    if (values.empty())
+        return 0.0;
+    auto rank = (size_t)ceil(q * values.size());
+    auto nth = values.begin() + (rank == 0 ? 0 : rank - 1);
+    nth_element(values.begin(), nth, values.end());
+    return *nth;
+}
+
+// The value of "key": "value" in a flat JSON reply
+static string json_string(const string& json, const string& key)
+{
+    auto pos = json.find("\"" + key + "\"");
+    if (pos != string::npos)
+        pos = json.find('"', json.find(':', pos) + 1);
+    if (pos == string::npos)
+        return "";
+    return json.substr(pos + 1, json.find('"', pos + 1) - pos - 1);
+}
+
+hsds_client::hsds_client(const string& endpoint)
+{
+    // http://host:port
+    auto host = endpoint;
+    if (host.rfind("http://", 0) == 0)
+        host.erase(0, 7);
+    else if (host.find("://") != string::npos)
+        throw runtime_error("Only http:// endpoints are supported: " + endpoint);
+    host = host.substr(0, host.find('/'));
+
+    port_ = 80;
+    if (auto colon = host.rfind(':'); colon != string::npos)
+    {
+        port_ = (uint16_t)stoi(host.substr(colon + 1));
+        host.erase(colon);
+    }
+    host_ = host;
+
+    auto user = getenv("HS_USERNAME");
+    auto password = getenv("HS_PASSWORD");
+    if (user != nullptr && password != nullptr)
+        authorization_ = "Authorization: Basic " + base64(string(user) + ":" + password);
+
+    connection_ = make_unique<http_connection>(host_, port_);
+}
+
+http_response hsds_client::request
+(
+    const string& method,
+    const string& target,
+    const string& content_type,
+    const char*   body,
+    size_t        body_size
+)
+{
+    vector<string> headers{"Content-Type: " + content_type, "Accept: " + content_type};
+    if (!authorization_.empty())
+        headers.push_back(authorization_);
+
+    auto start = chrono::steady_clock::now();
+    auto response = connection_->request(method, target, headers, body, body_size);
+    stats_.latencies.push_back(chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    ++stats_.requests;
+    stats_.bytes_sent += body_size;
+    stats_.bytes_received += response.body.size();
+    if (response.status < 200 || response.status >= 300)
+        throw runtime_error(method + " " + target + " failed with " + to_string(response.status) + ": " +
+                            response.body.substr(0, 200));
+    return response;
+}
+
+string hsds_client::create_domain(const string& domain)
+{
+    auto target = "/?domain=" + url_encode(domain);
+    // replace a domain left over from an earlier run
+    try
+    {
+        request("DELETE", target, "application/json", nullptr, 0);
+    }
+    catch (const runtime_error&)
+    {
+    }
+
+    auto reply = request("PUT", target, "application/json", nullptr, 0).body;
+    auto root = json_string(reply, "root");
+    if (root.empty())
+        throw runtime_error("No root group in the reply for " + domain);
+    return root;
+}
+
+string hsds_client::create_dataset
+(
+    const string& domain,
+    const string& root,
+    const string& name,
+    size_t        rows,
+    size_t        cols,
+    size_t        chunk_rows
+)
+{
+    auto body = "{\"type\": \"H5T_IEEE_F64LE\", \"shape\": [" + to_string(rows) + ", " + to_string(cols) + "], ";
+    if (chunk_rows > 0)
+        body += "\"creationProperties\": {\"layout\": {\"class\": \"H5D_CHUNKED\", \"dims\": [" +
+                to_string(chunk_rows) + ", " + to_string(cols) + "]}}, ";
+    body += "\"link\": {\"id\": \"" + root + "\", \"name\": \"" + name + "\"}}";
+    auto reply = request("POST", "/datasets?domain=" + url_encode(domain), "application/json", body.data(), body.size()).body;
+    auto id = json_string(reply, "id");
+    if (id.empty())
+        throw runtime_error("No id in the reply for dataset " + name);
+    return id;
+}
+
+// "/datasets/<id>/value?domain=...&select=[first:last,0:cols]"
+static string value_target(const string& domain, const string& id, size_t first, size_t last, size_t cols)
+{
+    auto select = "[" + to_string(first) + ":" + to_string(last) + ",0:" + to_string(cols) + "]";
+    return "/datasets/" + id + "/value?domain=" + url_encode(domain) + "&select=" + url_encode(select);
+}
+
+void hsds_client::write_rows
+(
+    const string& domain,
+    const string& id,
+    size_t        first,
+    size_t        last,
+    size_t        cols,
+    const double* data
+)
+{
+    request("PUT", value_target(domain, id, first, last, cols), "application/octet-stream",
+            reinterpret_cast<const char*>(data), (last - first) * cols * sizeof(double));
+}
+
+void hsds_client::read_rows
+(
+    const string& domain,
+    const string& id,
+    size_t        first,
+    size_t        last,
+    size_t        cols,
+    double*       data
+)
+{
+    auto reply = request("GET", value_target(domain, id, first, last, cols), "application/octet-stream", nullptr, 0);
+    auto size = (last - first) * cols * sizeof(double);
+    if (reply.body.size() != size)
+        throw runtime_error("Expected " + to_string(size) + " bytes but got " + to_string(reply.body.size()));
+    reply.body.copy(reinterpret_cast<char*>(data), size);
+}
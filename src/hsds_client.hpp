@@ -0,0 +1,91 @@
+#ifndef HSDS_CLIENT_HPP
+#define HSDS_CLIENT_HPP
+
+#include "http.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Counts what a client sent and received
+struct rest_stats
+{
+    std::size_t requests = 0;
+    std::size_t bytes_sent = 0;      // request bodies
+    std::size_t bytes_received = 0;  // response bodies
+    std::vector<double> latencies;   // seconds, one per request
+};
+
+// The `q`-quantile (0 to 1) of `values` by nearest rank, 0 if there are none
+extern double percentile(std::vector<double> values, double q);
+
+// A client of the HSDS REST API on one keep-alive connection
+//
+// It covers what the benchmarks need: creating a domain, creating a 2-D
+// dataset of doubles and writing and reading blocks of its rows as binary.
+// `endpoint` is "http://host:port"; the credentials come from HS_USERNAME and
+// HS_PASSWORD, if they are set. Failed requests throw std::runtime_error.
+class hsds_client
+{
+public:
+    explicit hsds_client(const std::string& endpoint);
+
+    // Creates (replaces) `domain` and returns the id of its root group
+    std::string create_domain(const std::string& domain);
+
+    // Creates a dataset of `rows` x `cols` doubles linked as `name` in the root
+    // group and returns its id; `chunk_rows` > 0 asks for chunks of that many
+    // rows (of all columns), else the server chooses
+    std::string create_dataset
+    (
+        const std::string& domain,
+        const std::string& root,
+        const std::string& name,
+        std::size_t        rows,
+        std::size_t        cols,
+        std::size_t        chunk_rows = 0
+    );
+
+    // Writes rows [first, last) of all `cols` columns of dataset `id`
+    void write_rows
+    (
+        const std::string& domain,
+        const std::string& id,
+        std::size_t        first,
+        std::size_t        last,
+        std::size_t        cols,
+        const double*      data
+    );
+
+    // Reads rows [first, last) of all `cols` columns of dataset `id`
+    void read_rows
+    (
+        const std::string& domain,
+        const std::string& id,
+        std::size_t        first,
+        std::size_t        last,
+        std::size_t        cols,
+        double*            data
+    );
+
+    const rest_stats& stats() const { return stats_; }
+
+private:
+    http_response request
+    (
+        const std::string& method,
+        const std::string& target,
+        const std::string& content_type,
+        const char*        body,
+        std::size_t        body_size
+    );
+
+    std::string                      host_;
+    uint16_t                         port_;
+    std::string                      authorization_;
+    std::unique_ptr<http_connection> connection_;
+    rest_stats                       stats_;
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef HSDS_DOMAIN_HPP
+#define HSDS_DOMAIN_HPP
+
+#include <cstdlib>
+#include <string>
+
+// The HSDS domain (file) path for `name`: in the folder $OU_HSDS_PREFIX if it
+// is set, else in the home folder of $HSDS_USERNAME (the REST VOL's user) or
+// $HS_USERNAME (h5pyd's), else in /home/vscode/ (the dev container)
+inline std::string hsds_domain(const std::string& name)
+{
+    if (auto prefix = std::getenv("OU_HSDS_PREFIX"); prefix != nullptr && *prefix != '\0')
+    {
+        std::string folder = prefix;
+        if (folder.back() != '/')
+            folder += '/';
+        return folder + name;
+    }
+    for (auto variable : {"HSDS_USERNAME", "HS_USERNAME"})
+        if (auto user = std::getenv(variable); user != nullptr && *user != '\0')
+            return std::string("/home/") + user + "/" + name;
+    return "/home/vscode/" + name;
+}
+
+#endif
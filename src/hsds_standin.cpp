@@ -0,0 +1,258 @@
+#include "hsds_standin.hpp"
+#include "http.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+// The value of `key` in the query of `target` ("/path?a=1&b=2"), decoded
+static string query_value(const string& target, const string& key)
+{
+    auto query = target.find('?');
+    if (query == string::npos)
+        return "";
+    for (size_t pos = query + 1; pos < target.size();)
+    {
+        auto next = min(target.find('&', pos), target.size());
+        auto pair = target.substr(pos, next - pos);
+        if (pair.rfind(key + "=", 0) == 0)
+            return url_decode(pair.substr(key.size() + 1));
+        pos = next + 1;
+    }
+    return "";
+}
+
+// The numbers in `text` in order, e.g., [2, 3] of "[2:3]"
+static vector<size_t> numbers(const string& text)
+{
+    vector<size_t> result;
+    for (size_t pos = 0; (pos = text.find_first_of("0123456789", pos)) != string::npos;)
+    {
+        size_t length;
+        result.push_back(stoull(text.substr(pos), &length));
+        pos += length;
+    }
+    return result;
+}
+
+// `s` seconds on the clock of the stand-in
+static chrono::steady_clock::duration seconds(double s)
+{
+    return chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(s));
+}
+
+hsds_standin::hsds_standin(double latency, double bandwidth, double link_bandwidth)
+: latency_(latency), bandwidth_(bandwidth), link_bandwidth_(link_bandwidth), listen_fd_(-1), port_(0),
+  stopping_(false), next_id_(0), requests_(0), link_free_(chrono::steady_clock::now())
+{
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0)
+        throw runtime_error("Cannot create a socket for the HSDS stand-in");
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;  // any free port
+    socklen_t length = sizeof(address);
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listen_fd_, 64) != 0 ||
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length) != 0)
+    {
+        ::close(listen_fd_);
+        throw runtime_error("Cannot listen on 127.0.0.1 for the HSDS stand-in");
+    }
+    port_ = ntohs(address.sin_port);
+
+    acceptor_ = thread([this] { accept_loop(); });
+}
+
+hsds_standin::~hsds_standin()
+{
+    stopping_ = true;
+    // wakes up `accept` and every `read` with an error
+    ::shutdown(listen_fd_, SHUT_RDWR);
+    acceptor_.join();
+    {
+        lock_guard<mutex> lock(mutex_);
+        for (auto fd : connections_)
+            ::shutdown(fd, SHUT_RDWR);
+    }
+    for (auto& worker : workers_)
+        worker.join();
+    ::close(listen_fd_);
+}
+
+string hsds_standin::endpoint() const
+{
+    return "http://127.0.0.1:" + to_string(port_);
+}
+
+void hsds_standin::accept_loop()
+{
+    while (!stopping_)
+    {
+        int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0)
+            continue;
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        lock_guard<mutex> lock(mutex_);
+        if (stopping_)
+        {
+            ::close(fd);
+            break;
+        }
+        connections_.push_back(fd);
+        workers_.emplace_back([this, fd] { serve(fd); });
+    }
+}
+
+void hsds_standin::serve(int fd)
+{
+    string buffer;
+    http_message request;
+    while (read_http_message(fd, buffer, request))
+    {
+        auto start = chrono::steady_clock::now();
+
+        // "PUT /datasets/d-1/value?... HTTP/1.1"
+        auto method_end = request.start_line.find(' ');
+        auto method = request.start_line.substr(0, method_end);
+        auto target = request.start_line.substr(method_end + 1, request.start_line.rfind(' ') - method_end - 1);
+        auto reply = handle(method, target, request.body);
+        ++requests_;
+
+        // a remote server would have answered this late: the bytes take their
+        // time on this connection and, queued behind the other connections,
+        // on the shared link
+        auto bytes = (double)(request.body.size() + reply.body.size());
+        auto done = start;
+        if (bandwidth_ > 0)
+            done += seconds(bytes / bandwidth_);
+        if (link_bandwidth_ > 0)
+        {
+            lock_guard<mutex> lock(link_mutex_);
+            link_free_ = max(link_free_, start) + seconds(bytes / link_bandwidth_);
+            done = max(done, link_free_);
+        }
+        this_thread::sleep_until(done + seconds(latency_));
+
+        auto head = "HTTP/1.1 " + to_string(reply.status) + (reply.status < 300 ? " OK" : " Error") +
+                    "\r\nContent-Type: " + reply.content_type +
+                    "\r\nContent-Length: " + to_string(reply.body.size()) + "\r\n\r\n";
+        if (!write_all(fd, head.data(), head.size()) || !write_all(fd, reply.body.data(), reply.body.size()))
+            break;
+    }
+
+    lock_guard<mutex> lock(mutex_);
+    connections_.erase(std::find(connections_.begin(), connections_.end(), fd));
+    ::close(fd);
+}
+
+shared_ptr<hsds_standin::dataset> hsds_standin::find(const string& id)
+{
+    lock_guard<mutex> lock(mutex_);
+    auto it = datasets_.find(id);
+    return it == datasets_.end() ? nullptr : it->second;
+}
+
+hsds_standin::response hsds_standin::handle(const string& method, const string& target, const string& body)
+{
+    const string json = "application/json";
+    auto path = target.substr(0, target.find('?'));
+    auto domain = query_value(target, "domain");
+
+    if (path == "/")
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (method == "PUT")
+        {
+            if (domains_.count(domain) != 0)
+                return {409, json, "{\"message\": \"domain exists\"}"};
+            auto root = "g-" + to_string(++next_id_);
+            domains_[domain] = root;
+            return {201, json, "{\"root\": \"" + root + "\"}"};
+        }
+        auto it = domains_.find(domain);
+        if (it == domains_.end())
+            return {404, json, "{\"message\": \"no such domain\"}"};
+        if (method == "DELETE")
+        {
+            domains_.erase(it);
+            for (auto d = datasets_.begin(); d != datasets_.end();)
+                d = d->second->domain == domain ? datasets_.erase(d) : next(d);
+            return {200, json, "{}"};
+        }
+        return {200, json, "{\"root\": \"" + it->second + "\"}"};
+    }
+
+    if (path == "/datasets" && method == "POST")
+    {
+        if (body.find("H5T_IEEE_F64LE") == string::npos)
+            return {400, json, "{\"message\": \"only H5T_IEEE_F64LE is supported\"}"};
+        auto shape = numbers(body.substr(body.find("\"shape\"")));
+        if (shape.size() < 2)
+            return {400, json, "{\"message\": \"expected a 2-D shape\"}"};
+
+        auto d = make_shared<dataset>();
+        d->domain = domain;
+        d->rows = shape[0];
+        d->cols = shape[1];
+        d->values.assign(d->rows * d->cols, 0.0);
+
+        lock_guard<mutex> lock(mutex_);
+        if (domains_.count(domain) == 0)
+            return {404, json, "{\"message\": \"no such domain\"}"};
+        auto id = "d-" + to_string(++next_id_);
+        datasets_[id] = d;
+        return {201, json, "{\"id\": \"" + id + "\"}"};
+    }
+
+    // /datasets/<id>/value
+    const string prefix = "/datasets/", suffix = "/value";
+    if (path.rfind(prefix, 0) == 0 && path.size() > prefix.size() + suffix.size() &&
+        path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0)
+    {
+        auto d = find(path.substr(prefix.size(), path.size() - prefix.size() - suffix.size()));
+        if (d == nullptr)
+            return {404, json, "{\"message\": \"no such dataset\"}"};
+
+        auto select = numbers(query_value(target, "select"));
+        if (select.empty())
+            select = {0, d->rows, 0, d->cols};
+        if (select.size() != 4 || select[0] > select[1] || select[1] > d->rows || select[2] > select[3] || select[3] > d->cols)
+            return {400, json, "{\"message\": \"bad selection\"}"};
+
+        auto cols = select[3] - select[2];
+        auto row_bytes = cols * sizeof(double);
+        auto size = (select[1] - select[0]) * row_bytes;
+        if (method == "PUT")
+        {
+            if (body.size() != size)
+                return {400, json, "{\"message\": \"expected " + to_string(size) + " bytes\"}"};
+            unique_lock<shared_mutex> lock(d->mutex);
+            for (auto r = select[0]; r < select[1]; ++r)
+                memcpy(&d->values[r * d->cols + select[2]], body.data() + (r - select[0]) * row_bytes, row_bytes);
+            return {200, json, "{}"};
+        }
+        if (method == "GET")
+        {
+            string values(size, '\0');
+            shared_lock<shared_mutex> lock(d->mutex);
+            for (auto r = select[0]; r < select[1]; ++r)
+                memcpy(&values[(r - select[0]) * row_bytes], &d->values[r * d->cols + select[2]], row_bytes);
+            return {200, "application/octet-stream", move(values)};
+        }
+    }
+
+    return {404, json, "{\"message\": \"not supported by the stand-in\"}"};
+}
@@ -0,0 +1,85 @@
+#ifndef HSDS_STANDIN_HPP
+#define HSDS_STANDIN_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// An in-process stand-in for an HSDS server on 127.0.0.1, for benchmarking
+// the REST path offline
+//
+// It answers the subset of the API that `hsds_client` uses (domains, 2-D
+// datasets of doubles, binary hyperslab values) from memory, one thread per
+// connection. The values of a dataset are not chunked: its creation properties
+// are accepted and ignored, so a request costs the same wherever it starts.
+// To look like a remote object store, every request waits `latency` seconds,
+// every connection moves at most `bandwidth` bytes per second, and all
+// connections together move at most `link_bandwidth` bytes per second
+// (0 = unlimited).
+class hsds_standin
+{
+public:
+    hsds_standin(double latency = 0.0, double bandwidth = 0.0, double link_bandwidth = 0.0);
+    ~hsds_standin();
+
+    hsds_standin(const hsds_standin&) = delete;
+    hsds_standin& operator=(const hsds_standin&) = delete;
+
+    // "http://127.0.0.1:<port>"
+    std::string endpoint() const;
+
+    // The number of requests served
+    std::size_t requests() const { return requests_; }
+
+private:
+    struct dataset
+    {
+        std::string         domain;
+        std::size_t         rows;
+        std::size_t         cols;
+        std::vector<double> values;
+        std::shared_mutex   mutex;   // shared for GET, unique for PUT
+    };
+
+    struct response
+    {
+        int         status;
+        std::string content_type;
+        std::string body;
+    };
+
+    void accept_loop();
+    void serve(int fd);
+    response handle(const std::string& method, const std::string& target, const std::string& body);
+    std::shared_ptr<dataset> find(const std::string& id);
+
+    double            latency_;
+    double            bandwidth_;
+    double            link_bandwidth_;
+    int               listen_fd_;
+    uint16_t          port_;
+    std::atomic<bool> stopping_;
+    std::thread       acceptor_;
+
+    std::mutex                                       mutex_;
+    std::list<std::thread>                           workers_;
+    std::vector<int>                                 connections_;
+    std::map<std::string, std::string>               domains_;   // domain -> root group id
+    std::map<std::string, std::shared_ptr<dataset>>  datasets_;  // id -> dataset
+    std::size_t                                      next_id_;
+    std::atomic<std::size_t>                         requests_;
+
+    std::mutex                            link_mutex_;
+    std::chrono::steady_clock::time_point link_free_;  // when the shared link has sent everything queued
+};
+
+#endif
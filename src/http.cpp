@@ -0,0 +1,239 @@
+#include "http.hpp"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <stdexcept>
+
+using namespace std;
+
+bool read_http_message(int fd, string& buffer, http_message& message, size_t* received)
+{
+    char chunk[1 << 16];
+    if (received)
+        *received = 0;
+    auto fill = [&]() {
+        ssize_t n;
+        do
+            n = ::read(fd, chunk, sizeof(chunk));
+        while (n < 0 && errno == EINTR);
+        if (n <= 0)
+            return false;
+        buffer.append(chunk, n);
+        if (received)
+            *received += n;
+        return true;
+    };
+
+    size_t end;
+    while ((end = buffer.find("\r\n\r\n")) == string::npos)
+        if (!fill())
+            return false;
+
+    message.headers.clear();
+    size_t line_end = buffer.find("\r\n");
+    message.start_line = buffer.substr(0, line_end);
+    for (size_t pos = line_end + 2; pos < end;)
+    {
+        size_t next = buffer.find("\r\n", pos);
+        auto line = buffer.substr(pos, next - pos);
+        auto colon = line.find(':');
+        if (colon != string::npos)
+        {
+            auto name = line.substr(0, colon);
+            transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return (char)tolower(c); });
+            auto value = line.substr(colon + 1);
+            value.erase(0, value.find_first_not_of(' '));
+            message.headers[name] = value;
+        }
+        pos = next + 2;
+    }
+
+    size_t length = 0;
+    if (auto it = message.headers.find("content-length"); it != message.headers.end())
+        length = stoull(it->second);
+    buffer.erase(0, end + 4);
+    message.body.reserve(length);
+    while (buffer.size() < length)
+        if (!fill())
+            return false;
+    message.body.assign(buffer, 0, length);
+    buffer.erase(0, length);
+    return true;
+}
+
+bool write_all(int fd, const char* data, size_t size)
+{
+    while (size > 0)
+    {
+        auto n = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+string url_encode(const string& text)
+{
+    static const char* hex = "0123456789ABCDEF";
+    string out;
+    for (unsigned char c : text)
+    {
+        if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~' || c == '/')
+            out += (char)c;
+        else
+        {
+            out += '%';
+            out += hex[c >> 4];
+            out += hex[c & 15];
+        }
+    }
+    return out;
+}
+
+string url_decode(const string& text)
+{
+    string out;
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        if (text[i] == '%' && i + 2 < text.size())
+        {
+            out += (char)stoi(text.substr(i + 1, 2), nullptr, 16);
+            i += 2;
+        }
+        else
+            out += text[i] == '+' ? ' ' : text[i];
+    }
+    return out;
+}
+
+string base64(const string& text)
+{
+    static const char* digits = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    string out;
+    size_t i = 0;
+    for (; i + 2 < text.size(); i += 3)
+    {
+        uint32_t n = ((unsigned char)text[i] << 16) | ((unsigned char)text[i + 1] << 8) | (unsigned char)text[i + 2];
+        for (int shift = 18; shift >= 0; shift -= 6)
+            out += digits[(n >> shift) & 63];
+    }
+    if (i < text.size())
+    {
+        uint32_t n = (unsigned char)text[i] << 16;
+        if (i + 1 < text.size())
+            n |= (unsigned char)text[i + 1] << 8;
+        out += digits[(n >> 18) & 63];
+        out += digits[(n >> 12) & 63];
+        out += i + 1 < text.size() ? digits[(n >> 6) & 63] : '=';
+        out += '=';
+    }
+    return out;
+}
+
+http_connection::http_connection(const string& host, uint16_t port)
+: host_(host), port_(port), fd_(-1)
+{
+    open();
+}
+
+http_connection::~http_connection()
+{
+    close();
+}
+
+void http_connection::open()
+{
+    addrinfo hints{}, *addresses = nullptr;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host_.c_str(), to_string(port_).c_str(), &hints, &addresses) != 0)
+        throw runtime_error("Cannot resolve " + host_);
+
+    for (auto* a = addresses; a != nullptr && fd_ < 0; a = a->ai_next)
+    {
+        fd_ = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd_ >= 0 && ::connect(fd_, a->ai_addr, a->ai_addrlen) != 0)
+        {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (fd_ < 0)
+        throw runtime_error("Cannot connect to " + host_ + ":" + to_string(port_));
+
+    // requests are small and waiting for their acknowledgment adds latency
+    int one = 1;
+    setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    buffer_.clear();
+}
+
+void http_connection::close()
+{
+    if (fd_ >= 0)
+        ::close(fd_);
+    fd_ = -1;
+}
+
+bool http_connection::closed_by_peer() const
+{
+    // an idle connection has nothing to read until the server closes it
+    char c;
+    ssize_t n;
+    do
+        n = ::recv(fd_, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    while (n < 0 && errno == EINTR);
+    return n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK);
+}
+
+http_response http_connection::request
+(
+    const string&         method,
+    const string&         target,
+    const vector<string>& headers,
+    const char*           body,
+    size_t                body_size
+)
+{
+    string head = method + " " + target + " HTTP/1.1\r\nHost: " + host_ + ":" + to_string(port_) + "\r\n";
+    for (auto& header : headers)
+        head += header + "\r\n";
+    head += "Content-Length: " + to_string(body_size) + "\r\n\r\n";
+
+    // a POST that reached the server may have created something already
+    bool retry = method != "POST";
+    for (int attempt = 0; attempt < 2; ++attempt)
+    {
+        if (fd_ >= 0 && closed_by_peer())
+            close();
+        if (fd_ < 0)
+            open();
+
+        http_message message;
+        size_t received = 0;
+        if (write_all(fd_, head.data(), head.size()) && write_all(fd_, body, body_size) &&
+            read_http_message(fd_, buffer_, message, &received))
+        {
+            // "HTTP/1.1 200 OK"
+            auto space = message.start_line.find(' ');
+            int status = space == string::npos ? 0 : atoi(message.start_line.c_str() + space + 1);
+            if (auto it = message.headers.find("connection"); it != message.headers.end() && it->second == "close")
+                close();
+            return {status, move(message.body)};
+        }
+        close();
+        if (!retry || received > 0)
+            break;
+    }
+    throw runtime_error("Lost the connection to " + host_ + ":" + to_string(port_));
+}
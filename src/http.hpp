@@ -0,0 +1,81 @@
+#ifndef HTTP_HPP
+#define HTTP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// A parsed HTTP/1.1 message (request or response)
+struct http_message
+{
+    std::string                        start_line;  // "GET /path HTTP/1.1" or "HTTP/1.1 200 OK"
+    std::map<std::string, std::string> headers;     // names in lower case
+    std::string                        body;        // may be binary
+};
+
+// Reads one message with a Content-Length body from `fd`; `buffer` carries
+// bytes that arrived after the message over to the next call. Returns false
+// when the peer closed the connection (or on an error). If `received` is
+// given, it is set to the number of bytes read from `fd`.
+extern bool read_http_message(int fd, std::string& buffer, http_message& message, std::size_t* received = nullptr);
+
+// Writes all of `size` bytes, returns false on an error
+extern bool write_all(int fd, const char* data, std::size_t size);
+
+// Percent-encodes everything but unreserved characters
+extern std::string url_encode(const std::string& text);
+
+// Decodes %XX escapes
+extern std::string url_decode(const std::string& text);
+
+// Encodes `text` in base64, e.g., for basic authentication
+extern std::string base64(const std::string& text);
+
+// The result of an HTTP request
+struct http_response
+{
+    int         status;  // e.g., 200
+    std::string body;    // may be binary
+};
+
+// One keep-alive HTTP/1.1 connection (plain HTTP, no TLS)
+//
+// Requests on one connection are sequential; use several connections for
+// concurrent requests. A connection that the server closed while idle is
+// reopened before the request is sent. A request that fails before any byte
+// of the response arrives is sent once more on a new connection, unless it is
+// a POST, which the server may have carried out already. Throws
+// std::runtime_error if the server cannot be reached.
+class http_connection
+{
+public:
+    http_connection(const std::string& host, uint16_t port);
+    ~http_connection();
+
+    http_connection(const http_connection&) = delete;
+    http_connection& operator=(const http_connection&) = delete;
+
+    // Sends a request with `headers` ("Name: value") and `body`, and waits for the response
+    http_response request
+    (
+        const std::string&              method,
+        const std::string&              target,
+        const std::vector<std::string>& headers,
+        const char*                     body,
+        std::size_t                     body_size
+    );
+
+private:
+    void open();
+    void close();
+    bool closed_by_peer() const;
+
+    std::string host_;
+    uint16_t    port_;
+    int         fd_;
+    std::string buffer_;
+};
+
+#endif
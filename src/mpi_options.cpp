@@ -0,0 +1,227 @@
+#include "mpi_options.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+// Splits "1048576,4194304" into {1048576, 4194304}
+template <typename T>
+static vector<T> parse_list(const string& list)
+{
+    vector<T> values;
+    stringstream ss(list);
+    string item;
+    while (getline(ss, item, ','))
+        if (!item.empty())
+            values.push_back((T)stoull(item));
+    return values;
+}
+
+void set_mpi_io_options(argparse::ArgumentParser& program)
+{
+    program.add_argument("--cb_nodes")
+    .help("chooses the number of collective buffering aggregators (MPI-IO hint)")
+    .default_value(string{});
+
+    program.add_argument("--cb_buffer_size")
+    .help("chooses the collective buffer size in bytes of each aggregator (MPI-IO hint)")
+    .default_value(string{});
+
+    program.add_argument("--romio_cb_write")
+    .help("chooses collective buffering for writes: enable, disable, or automatic (ROMIO hint)")
+    .default_value(string{});
+
+    program.add_argument("--romio_ds_write")
+    .help("chooses data sieving for writes: enable, disable, or automatic (ROMIO hint)")
+    .default_value(string{});
+
+    program.add_argument("--hint")
+    .help("sets any other MPI-IO hint, e.g., striping_factor=8 (repeatable)")
+    .default_value(vector<string>{})
+    .append();
+
+    program.add_argument("--alignment")
+    .help("aligns file objects to this many bytes, e.g., the Lustre stripe size (0 = no alignment)")
+    .default_value(size_t{0})
+    .scan<'u', size_t>();
+
+    program.add_argument("--align_threshold")
+    .help("only aligns objects of at least this many bytes")
+    .default_value(size_t{1})
+    .scan<'u', size_t>();
+
+    program.add_argument("--per_rank")
+    .help("prints the time every rank spends in every phase")
+    .default_value(false)
+    .implicit_value(true);
+
+    program.add_argument("--histogram")
+    .help("prints a histogram of the ranks' times of every phase")
+    .default_value(false)
+    .implicit_value(true);
+
+    program.add_argument("--independent")
+    .help("writes independently, so that ranks do not wait for the slowest; every rank owns the chunks it writes")
+    .default_value(false)
+    .implicit_value(true);
+
+    program.add_argument("--coll_metadata")
+    .help("reads and writes the file metadata collectively")
+    .default_value(false)
+    .implicit_value(true);
+
+    program.add_argument("--page_size")
+    .help("manages the file space in pages of this many bytes (paged aggregation; 0 = off)")
+    .default_value(size_t{0})
+    .scan<'u', size_t>();
+
+    program.add_argument("--stripe_size")
+    .help("chooses the subfiling stripe size in bytes; a comma-separated list with --sweep (0 = default)")
+    .default_value(string{"0"});
+
+    program.add_argument("--iocs_per_node")
+    .help("chooses the number of subfiling I/O concentrators per node; a list with --sweep (0 = default)")
+    .default_value(string{"0"});
+
+    program.add_argument("--ioc_threads")
+    .help("chooses the number of worker threads of each I/O concentrator; a list with --sweep (0 = default)")
+    .default_value(string{"0"});
+
+    program.add_argument("--sweep")
+    .help("writes the paths with MPI-IO and with every combination of the subfiling settings, and reports the bandwidths")
+    .default_value(false)
+    .implicit_value(true);
+}
+
+int get_mpi_io_options(const argparse::ArgumentParser& program, mpi_io_options& options)
+{
+    options.hints.clear();
+    for (auto key : {"cb_nodes", "cb_buffer_size", "romio_cb_write", "romio_ds_write"})
+    {
+        auto value = program.get<string>(string("--") + key);
+        if (value.empty())
+            continue;
+        if (string(key).rfind("romio_", 0) == 0 && value != "enable" && value != "disable" && value != "automatic") {
+            cerr << key << " must be enable, disable, or automatic" << endl;
+            return -1;
+        }
+        options.hints.emplace_back(key, value);
+    }
+    for (auto& hint : program.get<vector<string>>("--hint"))
+    {
+        auto eq = hint.find('=');
+        if (eq == string::npos || eq == 0) {
+            cerr << "Hints must look like key=value: " << hint << endl;
+            return -1;
+        }
+        options.hints.emplace_back(hint.substr(0, eq), hint.substr(eq + 1));
+    }
+
+    options.alignment = program.get<size_t>("--alignment");
+    options.align_threshold = program.get<size_t>("--align_threshold");
+    options.per_rank_timing = program.get<bool>("--per_rank");
+    options.histogram = program.get<bool>("--histogram");
+    options.independent = program.get<bool>("--independent");
+    options.coll_metadata = program.get<bool>("--coll_metadata");
+    options.page_size = program.get<size_t>("--page_size");
+    if (options.page_size > 0 && options.page_size < 512) {
+        cerr << "Page size must be at least 512 bytes" << endl;
+        return -1;
+    }
+
+    try {
+        options.stripe_sizes = parse_list<hsize_t>(program.get<string>("--stripe_size"));
+        options.iocs_per_node = parse_list<int>(program.get<string>("--iocs_per_node"));
+        options.ioc_threads = parse_list<int>(program.get<string>("--ioc_threads"));
+    }
+    catch (const exception&) {
+        cerr << "Subfiling settings must be (lists of) non-negative integers" << endl;
+        return -1;
+    }
+    options.sweep = program.get<bool>("--sweep");
+    for (auto* list : {&options.iocs_per_node, &options.ioc_threads})
+        if (list->empty())
+            list->push_back(0);
+    if (options.stripe_sizes.empty())
+        options.stripe_sizes.push_back(0);
+    if (!options.sweep && (options.stripe_sizes.size() > 1 || options.iocs_per_node.size() > 1 || options.ioc_threads.size() > 1)) {
+        cerr << "Lists of subfiling settings require --sweep" << endl;
+        return -1;
+    }
+#ifndef H5_HAVE_SUBFILING_VFD
+    if (program.is_used("--stripe_size") || program.is_used("--iocs_per_node") || program.is_used("--ioc_threads")) {
+        cerr << "This HDF5 library has no subfiling driver" << endl;
+        return -1;
+    }
+#endif
+
+    return 0;
+}
+
+MPI_Info make_mpi_info(const mpi_io_options& options)
+{
+    if (options.hints.empty())
+        return MPI_INFO_NULL;
+
+    MPI_Info info;
+    MPI_Info_create(&info);
+    for (auto& [key, value] : options.hints)
+        MPI_Info_set(info, key.c_str(), value.c_str());
+    return info;
+}
+
+void set_fapl_alignment(hid_t fapl, const mpi_io_options& options)
+{
+    if (options.alignment > 0)
+        H5Pset_alignment(fapl, options.align_threshold, options.alignment);
+}
+
+void set_fapl_metadata(hid_t fapl, const mpi_io_options& options)
+{
+    if (options.coll_metadata)
+    {
+        H5Pset_all_coll_metadata_ops(fapl, true);
+        H5Pset_coll_metadata_write(fapl, true);
+    }
+    // The page buffer (H5Pset_page_buffer_size) is not available with the MPI
+    // drivers; metadata blocks of a page give the same few large writes
+    if (options.page_size > 0)
+        H5Pset_meta_block_size(fapl, options.page_size);
+}
+
+hid_t make_fcpl(const mpi_io_options& options)
+{
+    auto fcpl = H5Pcreate(H5P_FILE_CREATE);
+    if (options.page_size > 0)
+    {
+        H5Pset_file_space_strategy(fcpl, H5F_FSPACE_STRATEGY_PAGE, false, 1);
+        H5Pset_file_space_page_size(fcpl, options.page_size);
+    }
+    return fcpl;
+}
+
+#ifdef H5_HAVE_SUBFILING_VFD
+void set_fapl_subfiling(hid_t fapl, hsize_t stripe_size, int iocs_per_node, int ioc_threads)
+{
+    if (iocs_per_node > 0)
+        setenv(H5FD_SUBFILING_IOC_PER_NODE, to_string(iocs_per_node).c_str(), 1);
+    else
+        unsetenv(H5FD_SUBFILING_IOC_PER_NODE);
+
+    // Start from the defaults and change what was asked for
+    H5FD_subfiling_config_t config;
+    H5Pget_fapl_subfiling(fapl, &config);
+    if (stripe_size > 0)
+        config.shared_cfg.stripe_size = stripe_size;
+    if (ioc_threads > 0)
+    {
+        H5FD_ioc_config_t ioc;
+        H5Pget_fapl_ioc(config.ioc_fapl_id, &ioc);
+        ioc.thread_pool_size = ioc_threads;
+        H5Pset_fapl_ioc(config.ioc_fapl_id, &ioc);
+    }
+    H5Pset_fapl_subfiling(fapl, &config);
+    H5Pclose(config.ioc_fapl_id);
+}
+#endif
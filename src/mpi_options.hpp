@@ -0,0 +1,60 @@
+#ifndef MPI_OPTIONS_HPP
+#define MPI_OPTIONS_HPP
+
+#include "argparse.hpp"
+#include "hdf5.h"
+#include <mpi.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+// How `ou_hdf5_mpi` drives MPI-IO
+struct mpi_io_options
+{
+    std::vector<std::pair<std::string, std::string>> hints;  // MPI-IO hints (cb_nodes, romio_*, striping_*, ...)
+    hsize_t                                          alignment;        // align objects of at least `align_threshold` bytes (0 = off)
+    hsize_t                                          align_threshold;
+    bool                                             per_rank_timing;  // print every rank's times, not just the spread
+    bool                                             histogram;        // print a histogram of the ranks' times of each phase
+    bool                                             independent;      // write independently instead of collectively
+    bool                                             coll_metadata;    // read and write the metadata collectively
+    hsize_t                                          page_size;        // file space page size (0 = no paged aggregation)
+
+    // Subfiling settings (0 = HDF5's default); each lists several values for a sweep
+    std::vector<hsize_t>                             stripe_sizes;     // bytes per stripe of the subfiles
+    std::vector<int>                                 iocs_per_node;    // I/O concentrators per node
+    std::vector<int>                                 ioc_threads;      // worker threads per I/O concentrator
+    bool                                             sweep;            // write with MPI-IO and every subfiling setting
+};
+
+// Sets the options for which we are looking
+extern void set_mpi_io_options(argparse::ArgumentParser& program);
+
+// Tests the options and retrieves the arguments
+extern int get_mpi_io_options(const argparse::ArgumentParser& program, mpi_io_options& options);
+
+// Creates the MPI_Info with the hints (MPI_INFO_NULL if there are none); the caller frees it
+extern MPI_Info make_mpi_info(const mpi_io_options& options);
+
+// Sets the file access properties (alignment) that do not depend on the driver
+extern void set_fapl_alignment(hid_t fapl, const mpi_io_options& options);
+
+// Makes all ranks read (and rank 0 write) the metadata collectively, instead
+// of every rank reading it on its own, and aggregates metadata in blocks of
+// the file space page size
+extern void set_fapl_metadata(hid_t fapl, const mpi_io_options& options);
+
+// Creates the file creation property list; with a page size, the file space
+// is managed in pages, so that metadata and raw data occupy separate, aligned
+// pages and the metadata is flushed in a few page-sized writes
+extern hid_t make_fcpl(const mpi_io_options& options);
+
+#ifdef H5_HAVE_SUBFILING_VFD
+// Selects the subfiling driver with the given settings (0 = HDF5's default)
+//
+// HDF5 reads the number of I/O concentrators per node only from the
+// environment, so this sets (or clears) H5FD_SUBFILING_IOC_PER_NODE.
+extern void set_fapl_subfiling(hid_t fapl, hsize_t stripe_size, int iocs_per_node, int ioc_threads);
+#endif
+
+#endif
@@ -1,5 +1,7 @@
 #include "hdf5.h"
+#include "hsds_domain.hpp"
 #include "rest_vol_public.h"
+#include "write_batch.hpp"
 
 #include <iostream>
 #include <sstream>
@@ -16,7 +18,7 @@ int main()
 
     hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
     H5Pset_fapl_rest_vol(fapl);
-    hid_t file = H5Fcreate("/home/vscode/multi_dataset.h5", H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+    hid_t file = H5Fcreate(hsds_domain("multi_dataset.h5").c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
     H5Pclose(fapl);
     
     vector<int> write_buf(NUM_DATASETS*NUM_INTEGERS), read_buf(NUM_DATASETS*NUM_INTEGERS);
@@ -46,7 +48,11 @@ int main()
             write_data[i][j] = i * 10000 + j;
     }
 
-    H5Dwrite_multi(NUM_DATASETS, dset_ids, type_ids, sel_space_ids, sel_space_ids, H5P_DEFAULT, (const void**)write_data);
+    // one request for all datasets
+    write_batch writes;
+    for (size_t i = 0; i < NUM_DATASETS; ++i)
+        writes.add(dset_ids[i], type_ids[i], sel_space_ids[i], sel_space_ids[i], write_data[i]);
+    writes.flush();
 
     H5Dread_multi(NUM_DATASETS, dset_ids, type_ids, sel_space_ids, sel_space_ids, H5P_DEFAULT, (void**) read_data);
 
@@ -0,0 +1,289 @@
+#include "ou_formats.hpp"
+#include "ou_sampler.hpp"
+
+#include "argparse.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef OU_HAVE_HDFQL
+#include "HDFql.hpp"
+#endif
+
+using namespace std;
+
+#ifdef OU_HAVE_HDFQL
+#define sstr(x) (query.str(""),query.clear(),query << x,query.str().c_str())
+
+// The HDFql counterparts of `write_hdf5` and `read_hdf5`
+static void write_hdfql(const string& file_name, const vector<double>& ou_process, const ou_header& header)
+{
+    ostringstream query;
+    HDFql::execute(sstr("CREATE TRUNCATE AND USE FILE \"" << file_name << "\""));
+    HDFql::execute(sstr("CREATE DATASET \"dataset\" AS DOUBLE(" << header.path_count << ", " << header.step_count
+                        << ") VALUES FROM MEMORY " << HDFql::variableTransientRegister(ou_process)));
+    HDFql::execute("CREATE ATTRIBUTE dataset/rows AS VARCHAR VALUES(\"path\")");
+    HDFql::execute("CREATE ATTRIBUTE dataset/columns AS VARCHAR VALUES(\"time\")");
+    HDFql::execute(sstr("CREATE ATTRIBUTE dataset/dt AS DOUBLE VALUES(" << header.dt << ")"));
+    HDFql::execute(sstr("CREATE ATTRIBUTE dataset/θ AS DOUBLE VALUES(" << header.theta << ")"));
+    HDFql::execute(sstr("CREATE ATTRIBUTE dataset/μ AS DOUBLE VALUES(" << header.mu << ")"));
+    HDFql::execute(sstr("CREATE ATTRIBUTE dataset/σ AS DOUBLE VALUES(" << header.sigma << ")"));
+    HDFql::execute("CLOSE FILE");
+}
+
+static bool read_hdfql(const string& file_name, vector<double>& ou_process, ou_header& header)
+{
+    ostringstream query;
+    if (HDFql::execute(sstr("USE READONLY FILE \"" << file_name << "\"")) != HDFql::Success)
+        return false;
+    ou_process.resize(header.path_count * header.step_count);
+    auto status = HDFql::execute(sstr("SELECT FROM dataset INTO MEMORY " << HDFql::variableTransientRegister(ou_process)));
+    HDFql::execute("CLOSE FILE");
+    return status == HDFql::Success;
+}
+#endif
+
+// A file format and how to write and read it
+struct ou_format
+{
+    string                                                                   name;
+    string                                                                   extension;
+    function<void(const string&, const vector<double>&, const ou_header&)>   write;
+    function<bool(const string&, vector<double>&, ou_header&)>               read;
+};
+
+// What one run of one writer measured
+struct bench_result
+{
+    double sample_seconds;
+    double write_seconds;
+    double read_seconds;
+    double file_bytes;
+    double disk_bytes;
+    int    read_ok;
+};
+
+// Splits "100,1000" into {100, 1000}
+static vector<size_t> parse_list(const string& list)
+{
+    vector<size_t> values;
+    stringstream ss(list);
+    string item;
+    while (getline(ss, item, ','))
+        if (!item.empty())
+            values.push_back(stoull(item));
+    return values;
+}
+
+// Samples, writes, and reads back one set of paths; runs in a child process,
+// so that its peak RSS is its own
+static bench_result run_case
+(
+    const ou_format&  format,
+    const string&     file_name,
+    const ou_header&  header,
+    const size_t&     thread_count,
+    const bool&       sync
+)
+{
+    using clock = chrono::steady_clock;
+    bench_result result{};
+
+    vector<double> ou_process;
+    auto t = clock::now();
+    ou_sampler(ou_process, header.path_count, header.step_count, header.dt, header.theta, header.mu, header.sigma,
+               0, 0, 0, thread_count);
+    result.sample_seconds = chrono::duration<double>(clock::now() - t).count();
+
+    t = clock::now();
+    format.write(file_name, ou_process, header);
+    if (sync)
+    {
+        auto fd = open(file_name.c_str(), O_RDONLY);
+        fsync(fd);
+        close(fd);
+    }
+    result.write_seconds = chrono::duration<double>(clock::now() - t).count();
+
+    struct stat st;
+    if (stat(file_name.c_str(), &st) == 0)
+    {
+        result.file_bytes = (double)st.st_size;
+        result.disk_bytes = (double)st.st_blocks * 512;
+    }
+
+    // Read into a fresh buffer (from the page cache, unless it has been dropped)
+    vector<double> back;
+    ou_header back_header = header;
+    t = clock::now();
+    result.read_ok = format.read(file_name, back, back_header);
+    result.read_seconds = chrono::duration<double>(clock::now() - t).count();
+    result.read_ok = result.read_ok && back == ou_process;  // every writer must round-trip exactly
+
+    return result;
+}
+
+// Compares the writers on a sweep of path and step counts
+//
+// Every (format, paths, steps, repetition) runs in a forked child, which samples
+// the paths, writes them, and reads them back. Sampling, writing, and reading
+// are timed separately, and the parent adds the child's peak RSS. The run
+// fails (exit status 1) if any format does not read back what it wrote.
+int main(int argc, char *argv[])
+{
+    argparse::ArgumentParser program("ou_bench");
+    program.add_argument("-p", "--paths")
+    .help("chooses the path counts to sweep (comma separated)")
+    .default_value(string{"100,1000"});
+    program.add_argument("-s", "--steps")
+    .help("chooses the step counts to sweep (comma separated)")
+    .default_value(string{"1000,10000"});
+    program.add_argument("-f", "--formats")
+    .help("chooses the writers to compare (comma separated: text, binary, hdf5, hdfql)")
+#ifdef OU_HAVE_HDFQL
+    .default_value(string{"text,binary,hdf5,hdfql"});
+#else
+    .default_value(string{"text,binary,hdf5"});
+#endif
+    program.add_argument("-r", "--repeat")
+    .help("chooses the number of runs of each case")
+    .default_value(size_t{3})
+    .scan<'u', size_t>();
+    program.add_argument("-j", "--threads")
+    .help("chooses the number of sampler threads (0 = one per hardware thread)")
+    .default_value(size_t{0})
+    .scan<'u', size_t>();
+    program.add_argument("-d", "--dir")
+    .help("chooses the directory for the files written")
+    .default_value(string{"."});
+    program.add_argument("--sync")
+    .help("counts an fsync of the file as part of writing it")
+    .default_value(false)
+    .implicit_value(true);
+    program.add_argument("--keep")
+    .help("keeps the files written")
+    .default_value(false)
+    .implicit_value(true);
+    program.add_argument("--csv")
+    .help("writes the results to this CSV file");
+    program.add_argument("--json")
+    .help("writes the results to this JSON file");
+    program.parse_args(argc, argv);
+
+    auto path_counts = parse_list(program.get<string>("--paths"));
+    auto step_counts = parse_list(program.get<string>("--steps"));
+    auto repeat = program.get<size_t>("--repeat");
+    auto thread_count = program.get<size_t>("--threads");
+    auto dir = program.get<string>("--dir");
+    auto sync = program.get<bool>("--sync");
+    auto keep = program.get<bool>("--keep");
+
+    vector<ou_format> known = {
+        {"text", "txt", [&](const string& name, const vector<double>& x, const ou_header& h) { write_text(name, x, h, thread_count); }, read_text},
+        {"binary", "bin", write_binary, read_binary},
+        {"hdf5", "h5", write_hdf5, read_hdf5},
+#ifdef OU_HAVE_HDFQL
+        {"hdfql", "hdfql.h5", write_hdfql, read_hdfql},
+#endif
+    };
+    vector<ou_format> formats;
+    stringstream ss(program.get<string>("--formats"));
+    for (string name; getline(ss, name, ',');)
+    {
+        size_t k = 0;
+        while (k < known.size() && known[k].name != name)
+            ++k;
+        if (k == known.size()) {
+            cerr << "Unknown or unavailable format " << name << endl;
+            return 1;
+        }
+        formats.push_back(known[k]);
+    }
+
+    ostringstream csv, json;
+    csv << "format,paths,steps,run,mib,sample_s,write_s,write_mib_s,read_s,read_mib_s,file_bytes,disk_bytes,peak_rss_kib,read_ok\n";
+    json << "[";
+    printf("%-8s %8s %8s %4s %10s %10s %10s %12s %10s %12s %12s %12s\n", "format", "paths", "steps", "run", "MiB",
+           "sample s", "write s", "write MiB/s", "read s", "read MiB/s", "disk MiB", "peak RSS MiB");
+
+    bool first_row = true, all_read_ok = true;
+    for (auto path_count : path_counts)
+        for (auto step_count : step_counts)
+            for (auto& format : formats)
+                for (size_t run = 0; run < repeat; ++run)
+                {
+                    ou_header header{path_count, step_count, 0.01, 1.0, 0.0, 0.1};
+                    auto file_name = dir + "/ou_bench." + format.extension;
+
+                    int pipe_fd[2];
+                    if (pipe(pipe_fd) != 0) {
+                        cerr << "Cannot create a pipe" << endl;
+                        return 1;
+                    }
+                    fflush(stdout);
+                    auto child = fork();
+                    if (child == 0)
+                    {
+                        close(pipe_fd[0]);
+                        auto result = run_case(format, file_name, header, thread_count, sync);
+                        auto written = write(pipe_fd[1], &result, sizeof(result));
+                        _exit(written == sizeof(result) ? 0 : 1);
+                    }
+                    close(pipe_fd[1]);
+                    bench_result result{};
+                    auto got = read(pipe_fd[0], &result, sizeof(result));
+                    close(pipe_fd[0]);
+                    int status;
+                    struct rusage usage;
+                    wait4(child, &status, 0, &usage);
+                    if (got != sizeof(result) || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                        cerr << format.name << " failed for " << path_count << " x " << step_count << endl;
+                        return 1;
+                    }
+                    if (!keep)
+                        remove(file_name.c_str());
+
+                    double mib = (double)path_count * step_count * sizeof(double) / (1 << 20);
+                    long peak_kib = usage.ru_maxrss;  // KiB on Linux
+                    printf("%-8s %8zu %8zu %4zu %10.2f %10.4f %10.4f %12.1f %10.4f %12.1f %12.2f %12.1f%s\n",
+                           format.name.c_str(), path_count, step_count, run, mib, result.sample_seconds,
+                           result.write_seconds, mib / result.write_seconds, result.read_seconds,
+                           mib / result.read_seconds, result.disk_bytes / (1 << 20), peak_kib / 1024.0,
+                           result.read_ok ? "" : " (read back FAILED)");
+
+                    csv << format.name << "," << path_count << "," << step_count << "," << run << "," << mib << ","
+                        << result.sample_seconds << "," << result.write_seconds << "," << mib / result.write_seconds << ","
+                        << result.read_seconds << "," << mib / result.read_seconds << "," << (size_t)result.file_bytes << ","
+                        << (size_t)result.disk_bytes << "," << peak_kib << "," << result.read_ok << "\n";
+
+                    json << (first_row ? "\n" : ",\n")
+                         << "  {\"format\": \"" << format.name << "\", \"paths\": " << path_count << ", \"steps\": " << step_count
+                         << ", \"run\": " << run << ", \"mib\": " << mib << ", \"sample_s\": " << result.sample_seconds
+                         << ", \"write_s\": " << result.write_seconds << ", \"write_mib_s\": " << mib / result.write_seconds
+                         << ", \"read_s\": " << result.read_seconds << ", \"read_mib_s\": " << mib / result.read_seconds
+                         << ", \"file_bytes\": " << (size_t)result.file_bytes << ", \"disk_bytes\": " << (size_t)result.disk_bytes
+                         << ", \"peak_rss_kib\": " << peak_kib << ", \"read_ok\": " << (result.read_ok ? "true" : "false") << "}";
+                    first_row = false;
+                    all_read_ok = all_read_ok && result.read_ok;
+                }
+    json << "\n]\n";
+
+    if (program.present("--csv"))
+        ofstream(program.get<string>("--csv")) << csv.str();
+    if (program.present("--json"))
+        ofstream(program.get<string>("--json")) << json.str();
+
+    // a format that does not read back what it wrote fails the benchmark
+    return all_read_ok ? 0 : 1;
+}
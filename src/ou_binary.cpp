@@ -1,6 +1,6 @@
 #include "ou_sampler.hpp"
+#include "ou_formats.hpp"
 
-#include <fstream>
 #include <iostream>
 #include <vector>
 
@@ -10,25 +10,20 @@ int main()
 {
     const size_t path_count = 100, step_count = 1000;
     const double dt = 0.01, theta = 1.0, mu = 0.0, sigma = 0.1;
+    const uint64_t seed = 0;
+    const uint32_t stream = 0;
 
     cout << "Running with parameters:"
          << " paths=" << path_count << " steps=" << step_count
-         << " dt=" << dt << " theta=" << theta << " mu=" << mu << " sigma=" << sigma << endl;
+         << " dt=" << dt << " theta=" << theta << " mu=" << mu << " sigma=" << sigma
+         << " seed=" << seed << " stream=" << stream << endl;
 
     vector<double> ou_process;
-    ou_sampler(ou_process, path_count, step_count, dt, theta, mu, sigma);
+    ou_sampler(ou_process, path_count, step_count, dt, theta, mu, sigma, seed, stream, 0, 0);
     
     // Write the sample paths to an unformatted binary file
-
-    ofstream file("ou_process.bin", ios::out | ios::binary);
-    file.write((char *)&path_count, sizeof(path_count));
-    file.write((char *)&step_count, sizeof(step_count));
-    file.write((char *)&dt, sizeof(dt));
-    file.write((char *)&theta, sizeof(theta));
-    file.write((char *)&mu, sizeof(mu));
-    file.write((char *)&sigma, sizeof(sigma));
-    file.write((char *)ou_process.data(), sizeof(double) * ou_process.size());
-    file.close();
+    if (!write_binary("ou_process.bin", ou_process, {path_count, step_count, dt, theta, mu, sigma}))
+        return 1;
 
     return 0;
 }
@@ -0,0 +1,560 @@
+#include "ou_formats.hpp"
+#include "hdf5_options.hpp"
+#include "batch_queue.hpp"
+#include "bitround.hpp"
+#include "docstring.hpp"
+#include "thread_pool.hpp"
+
+#include "argparse.hpp"
+#include "hdf5.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// A block of rows on its way from the input to the output file
+struct row_block
+{
+    size_t            first;   // index of the first row
+    size_t            rows;
+    vector<char>      text;    // the rows as text (read from or written to a text file)
+    vector<double>    values;  // the rows as doubles
+    future<void>      converted;
+};
+
+// Reads a file a block of rows at a time, in order
+class row_source
+{
+public:
+    virtual ~row_source() {}
+
+    // Reads the next `b.rows` rows into `b.text` (text files) or `b.values` (others)
+    virtual bool read(row_block& b) = 0;
+
+    virtual bool is_text() const { return false; }
+
+    ou_header          header{};
+    map<string,string> docstrings;  // string attributes of `/dataset` worth keeping
+};
+
+// Writes a file a block of rows at a time, in order
+class row_sink
+{
+public:
+    virtual ~row_sink() {}
+
+    // Writes `b.text` (text files) or `b.values` (others)
+    virtual bool write(const row_block& b) = 0;
+    virtual bool close() = 0;
+
+    virtual bool is_text() const { return false; }
+};
+
+class text_source : public row_source
+{
+public:
+    bool open(const string& file_name)
+    {
+        file_.open(file_name);
+        return read_text_header(file_, header);
+    }
+
+    bool read(row_block& b) override
+    {
+        // Leave the parsing to the convert stage; here we only find the lines
+        b.text.clear();
+        for (size_t i = 0; i < b.rows; ++i)
+        {
+            if (!getline(file_, line_))
+                return false;
+            b.text.insert(b.text.end(), line_.begin(), line_.end());
+            b.text.push_back('\n');
+        }
+        return true;
+    }
+
+    bool is_text() const override { return true; }
+
+private:
+    ifstream file_;
+    string   line_;
+};
+
+class binary_source : public row_source
+{
+public:
+    bool open(const string& file_name)
+    {
+        if (!paths_.open(file_name))
+        {
+            cerr << paths_.error() << endl;
+            return false;
+        }
+        header = paths_.header();
+        return true;
+    }
+
+    bool read(row_block& b) override
+    {
+        b.values.assign(paths_.row(b.first), paths_.row(b.first + b.rows));
+        return true;
+    }
+
+private:
+    binary_paths paths_;
+};
+
+class hdf5_source : public row_source
+{
+public:
+    ~hdf5_source()
+    {
+        if (file_ >= 0)
+        {
+            H5Sclose(space_);
+            H5Dclose(dataset_);
+            H5Fclose(file_);
+        }
+    }
+
+    bool open(const string& file_name)
+    {
+        file_ = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+        if (file_ < 0)
+            return false;
+        dataset_ = H5Dopen(file_, "/dataset", H5P_DEFAULT);
+        if (dataset_ < 0)
+        {
+            cerr << file_name << " has no /dataset" << endl;
+            H5Fclose(file_);
+            file_ = -1;
+            return false;
+        }
+        space_ = H5Dget_space(dataset_);
+        hsize_t dims[2] = {0, 0};
+        if (H5Sget_simple_extent_ndims(space_) != 2)
+        {
+            cerr << file_name << ": /dataset is not two-dimensional" << endl;
+            return false;
+        }
+        H5Sget_simple_extent_dims(space_, dims, NULL);
+
+        auto get_attribute = [&](const string& key) {
+            double value = 0.0;
+            if (H5Aexists_by_name(file_, "dataset", key.c_str(), H5P_DEFAULT) > 0)
+            {
+                auto attr = H5Aopen_by_name(file_, "dataset", key.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+                H5Aread(attr, H5T_NATIVE_DOUBLE, &value);
+                H5Aclose(attr);
+            }
+            return value;
+        };
+        header = {dims[0], dims[1], get_attribute("dt"), get_attribute("θ"), get_attribute("μ"), get_attribute("σ")};
+
+        for (auto key : {"comment", "Wikipedia", "generator", "seed", "stream", "first_path"})
+        {
+            auto value = get_docstring(file_, "dataset", key);
+            if (!value.empty())
+                docstrings[key] = value;
+        }
+        return true;
+    }
+
+    bool read(row_block& b) override
+    {
+        hsize_t start[] = {(hsize_t)b.first, 0};
+        hsize_t count[] = {(hsize_t)b.rows, (hsize_t)header.step_count};
+        b.values.resize(b.rows * header.step_count);
+        H5Sselect_hyperslab(space_, H5S_SELECT_SET, start, NULL, count, NULL);
+        auto mem_space = H5Screate_simple(2, count, NULL);
+        auto status = H5Dread(dataset_, H5T_NATIVE_DOUBLE, mem_space, space_, H5P_DEFAULT, b.values.data());
+        H5Sclose(mem_space);
+        return status >= 0;
+    }
+
+private:
+    hid_t file_ = -1, dataset_ = -1, space_ = -1;
+};
+
+class text_sink : public row_sink
+{
+public:
+    bool open(const string& file_name, const ou_header& header)
+    {
+        file_.open(file_name, ios::out | ios::binary);
+        write_text_header(file_, header);
+        return (bool)file_;
+    }
+
+    bool write(const row_block& b) override
+    {
+        file_.write(b.text.data(), b.text.size());
+        return (bool)file_;
+    }
+
+    bool close() override
+    {
+        file_.close();
+        return !file_.fail();
+    }
+
+    bool is_text() const override { return true; }
+
+private:
+    ofstream file_;
+};
+
+class binary_sink : public row_sink
+{
+public:
+    bool open(const string& file_name, const ou_header& header)
+    {
+        return writer_.open(file_name, header);
+    }
+
+    bool write(const row_block& b) override
+    {
+        return writer_.write_rows(b.first, b.values.data(), b.rows);
+    }
+
+    bool close() override
+    {
+        writer_.close();
+        return true;
+    }
+
+private:
+    binary_writer writer_;
+};
+
+class hdf5_sink : public row_sink
+{
+public:
+    bool open(const string& file_name, const ou_header& header, const hdf5_options& options,
+              const map<string,string>& docstrings)
+    {
+        header_ = header;
+        options_ = options;
+        docstrings_ = docstrings;
+        file_ = H5Fcreate(file_name.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+        if (file_ < 0)
+            return false;
+        add_docstring(file_, ".", "source", "https://github.com/HDFGroup/hdf5-tutorial");
+
+        hsize_t dimsf[] = {(hsize_t)header.path_count, (hsize_t)header.step_count};
+        space_ = H5Screate_simple(2, dimsf, NULL);
+        auto dcpl = make_dcpl(options, header.path_count, header.step_count);
+        dataset_ = H5Dcreate(file_, "/dataset", H5T_NATIVE_DOUBLE, space_, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+        H5Pclose(dcpl);
+        return dataset_ >= 0;
+    }
+
+    bool write(const row_block& b) override
+    {
+        hsize_t start[] = {(hsize_t)b.first, 0};
+        hsize_t count[] = {(hsize_t)b.rows, (hsize_t)header_.step_count};
+        H5Sselect_hyperslab(space_, H5S_SELECT_SET, start, NULL, count, NULL);
+        auto mem_space = H5Screate_simple(2, count, NULL);
+        auto status = H5Dwrite(dataset_, H5T_NATIVE_DOUBLE, mem_space, space_, H5P_DEFAULT, b.values.data());
+        H5Sclose(mem_space);
+        return status >= 0;
+    }
+
+    bool close() override
+    {
+        // make the file self-describing, as `ou_hdf5` does
+        add_docstring(file_, "dataset", "rows", "path");
+        add_docstring(file_, "dataset", "columns", "time");
+        for (auto& [key, value] : docstrings_)
+            add_docstring(file_, "dataset", key, value);
+        add_lossy_attributes(file_, "dataset", options_);
+
+        auto scalar = H5Screate(H5S_SCALAR);
+        auto acpl = H5Pcreate(H5P_ATTRIBUTE_CREATE);
+        H5Pset_char_encoding(acpl, H5T_CSET_UTF8);
+        auto set_attribute = [&](const string& name, const double& value) {
+            auto attr = H5Acreate_by_name(file_, "dataset", name.c_str(), H5T_NATIVE_DOUBLE, scalar, acpl, H5P_DEFAULT, H5P_DEFAULT);
+            H5Awrite(attr, H5T_NATIVE_DOUBLE, &value);
+            H5Aclose(attr);
+        };
+        set_attribute("dt", header_.dt);
+        set_attribute("θ", header_.theta);
+        set_attribute("μ", header_.mu);
+        set_attribute("σ", header_.sigma);
+        H5Pclose(acpl);
+        H5Sclose(scalar);
+
+        H5Sclose(space_);
+        H5Dclose(dataset_);
+        return H5Fclose(file_) >= 0;
+    }
+
+    // The stored size of the dataset, for the compression ratio
+    double stored_bytes() const
+    {
+        H5Dflush(dataset_);
+        return (double)H5Dget_storage_size(dataset_);
+    }
+
+private:
+    ou_header          header_{};
+    hdf5_options       options_;
+    map<string,string> docstrings_;
+    hid_t              file_ = -1, space_ = -1, dataset_ = -1;
+};
+
+// "text", "binary", or "hdf5", from the first bytes of an existing file
+static string detect_format(const string& file_name)
+{
+    char magic[8] = {0};
+    ifstream(file_name, ios::in | ios::binary).read(magic, sizeof(magic));
+    if (memcmp(magic, "\x89HDF\r\n\x1a\n", 8) == 0)
+        return "hdf5";
+    if (memcmp(magic, "\x89OUBIN\r\n", 8) == 0)
+        return "binary";
+    return "text";
+}
+
+// "text", "binary", or "hdf5", from the extension of a file name
+static string format_of_name(const string& file_name)
+{
+    auto dot = file_name.rfind('.');
+    auto ext = (dot == string::npos) ? string{} : file_name.substr(dot + 1);
+    if (ext == "txt")
+        return "text";
+    if (ext == "bin")
+        return "binary";
+    if (ext == "h5" || ext == "hdf5")
+        return "hdf5";
+    return "";
+}
+
+// Converts sample paths between the text, binary, and HDF5 files of `ou-text`,
+// `ou-binary`, and `ou-hdf5`, without holding more than a few blocks of rows
+//
+// Three stages run at the same time: this thread reads blocks, a thread pool
+// parses or formats them (and bit-rounds them for --lossy bitround), and a
+// writer thread writes them in order. From HDF5 to HDF5 with a library that is
+// not threadsafe, this thread also writes the blocks, a few blocks behind its
+// reads, so that only the conversions overlap. The HDF5 output takes the layout and
+// filter options of `ou-hdf5`, so a file can be re-chunked and re-compressed.
+int main(int argc, char *argv[])
+{
+    argparse::ArgumentParser program("ou_convert");
+    program.add_argument("input")
+    .help("chooses the file to convert (text, binary, or HDF5, recognized by its contents)");
+    program.add_argument("output")
+    .help("chooses the file to write (its format follows from .txt, .bin, or .h5 unless --to is given)");
+    program.add_argument("--to")
+    .help("chooses the output format: text, binary, or hdf5")
+    .default_value(string{});
+    set_hdf5_options(program);
+    // the options of `ou-hdf5` describe generating paths, not converting them
+    program["--block"].help("chooses the number of paths read and written at a time (0 = about 16 MiB)");
+    program["--threads"].help("chooses the number of threads that parse, format, and bit-round blocks (0 = one per hardware thread)");
+    program.parse_args(argc, argv);
+
+    hdf5_options options;
+    if (get_hdf5_options(program, options) < 0)
+        return 1;
+
+    auto input = program.get<string>("input"), output = program.get<string>("output");
+    auto from = detect_format(input);
+    auto to = program.get<string>("--to");
+    if (to.empty())
+        to = format_of_name(output);
+    if (to != "text" && to != "binary" && to != "hdf5") {
+        cerr << "Cannot tell the output format from " << output << "; please use --to" << endl;
+        return 1;
+    }
+    if (to != "hdf5" && (!options.chunk.empty() || !options.lossy.empty())) {
+        cerr << "Layout, filter, and lossy options only apply to HDF5 output" << endl;
+        return 1;
+    }
+
+    unique_ptr<row_source> source;
+    bool opened = false;
+    if (from == "text")
+    {
+        auto s = make_unique<text_source>();
+        opened = s->open(input);
+        source = move(s);
+    }
+    else if (from == "binary")
+    {
+        auto s = make_unique<binary_source>();
+        opened = s->open(input);
+        source = move(s);
+    }
+    else
+    {
+        auto s = make_unique<hdf5_source>();
+        opened = s->open(input);
+        source = move(s);
+    }
+    if (!opened) {
+        cerr << "Cannot read " << input << " as a " << from << " file" << endl;
+        return 1;
+    }
+    auto header = source->header;
+
+    // Blocks of about 16 MiB of doubles, in whole chunks of the output
+    size_t block_rows = options.block_rows;
+    if (block_rows == 0)
+        block_rows = max<size_t>(1, (16 << 20) / (sizeof(double) * max<size_t>(1, header.step_count)));
+    hsize_t chunk[2] = {0, 0};
+    if (to == "hdf5")
+        chunk_shape(options, header.path_count, header.step_count, chunk);
+    if (chunk[0] > 0)
+        block_rows = (block_rows + chunk[0] - 1) / chunk[0] * chunk[0];
+    block_rows = max<size_t>(1, min(block_rows, header.path_count));
+
+    unique_ptr<row_sink> sink;
+    hdf5_sink* hdf5_out = nullptr;
+    if (to == "text")
+    {
+        auto s = make_unique<text_sink>();
+        opened = s->open(output, header);
+        sink = move(s);
+    }
+    else if (to == "binary")
+    {
+        auto s = make_unique<binary_sink>();
+        opened = s->open(output, header);
+        sink = move(s);
+    }
+    else
+    {
+        auto s = make_unique<hdf5_sink>();
+        opened = s->open(output, header, options, source->docstrings);
+        hdf5_out = s.get();
+        sink = move(s);
+    }
+    if (!opened) {
+        cerr << "Cannot create " << output << endl;
+        return 1;
+    }
+
+    cout << "Converting " << input << " (" << from << ") to " << output << " (" << to << "): "
+         << header.path_count << " x " << header.step_count << " paths, block=" << block_rows;
+    if (chunk[0] > 0)
+        cout << " chunk=" << chunk[0] << "x" << chunk[1] << " shuffle=" << options.shuffle
+             << " deflate=" << options.deflate << " fletcher32=" << options.fletcher32;
+    if (!options.lossy.empty())
+        cout << " lossy=" << options.lossy << " error=" << options.error_bound;
+    cout << endl;
+
+    // The convert stage: text in and/or text out, and bit-rounding
+    auto keepbits = bitround_keepbits(options.error_bound);
+    auto convert = [&](row_block& b) {
+        if (source->is_text())
+        {
+            b.values.resize(b.rows * header.step_count);
+            if (!parse_text_values(b.text.data(), b.text.data() + b.text.size(), b.values.data(), b.values.size()))
+                throw runtime_error("rows " + to_string(b.first) + " to " + to_string(b.first + b.rows) + " are short of values");
+        }
+        if (options.lossy == "bitround")
+            bitround(b.values.data(), b.values.size(), keepbits);
+        if (sink->is_text())
+            format_text_rows(b.values.data(), b.rows, header.step_count, b.text);
+    };
+
+    using clock = chrono::steady_clock;
+    auto started = clock::now();
+
+    thread_pool converters(options.thread_count);
+    vector<row_block> blocks(2 * converters.size() + 2);
+    batch_queue<row_block*> empty(blocks.size()), full(blocks.size());
+    for (auto& b : blocks)
+        empty.push(&b);
+
+    // H5Dread on this thread and H5Dwrite on the writer thread may only overlap
+    // in a threadsafe build of HDF5; without one, an HDF5 to HDF5 conversion
+    // writes on this thread, `lag` blocks behind the reads, so that the
+    // converters keep up to `lag` blocks in flight
+    hbool_t threadsafe = false;
+    H5is_library_threadsafe(&threadsafe);
+    bool overlap = threadsafe || from != "hdf5" || to != "hdf5";
+    size_t lag = max<size_t>(1, converters.size());
+    deque<row_block*> pending;
+
+    atomic<bool> failed{false};
+    auto write = [&](row_block* b) {
+        try
+        {
+            b->converted.get();
+            if (!failed && !sink->write(*b)) {
+                cerr << "Cannot write rows " << b->first << " to " << b->first + b->rows << endl;
+                failed = true;
+            }
+        }
+        catch (const exception& e)
+        {
+            cerr << input << ": " << e.what() << endl;
+            failed = true;
+        }
+        empty.push(b);
+    };
+    thread writer;
+    if (overlap)
+        writer = thread([&] {
+            row_block* b = nullptr;
+            while (full.pop(b))
+                write(b);
+        });
+
+    for (size_t row = 0; row < header.path_count && !failed; row += block_rows)
+    {
+        row_block* b = nullptr;
+        empty.pop(b);
+        b->first = row;
+        b->rows = min(block_rows, header.path_count - row);
+        if (!source->read(*b)) {
+            cerr << "Cannot read rows " << row << " to " << row + b->rows << " of " << input << endl;
+            failed = true;
+            empty.push(b);
+            break;
+        }
+        b->converted = converters.submit([&, b] { convert(*b); });
+        if (overlap)
+            full.push(b);
+        else
+        {
+            pending.push_back(b);
+            if (pending.size() > lag)
+            {
+                write(pending.front());
+                pending.pop_front();
+            }
+        }
+    }
+    for (; !pending.empty(); pending.pop_front())
+        write(pending.front());
+    full.close();
+    if (writer.joinable())
+        writer.join();
+
+    double stored = hdf5_out ? hdf5_out->stored_bytes() : 0.0;
+    failed = !sink->close() || failed;
+    chrono::duration<double> total = clock::now() - started;
+    if (failed)
+        return 1;
+
+    double mib = (double)header.path_count * header.step_count * sizeof(double) / (1 << 20);
+    cout << "Converted " << mib << " MiB in " << total.count() << " s (" << mib / total.count() << " MiB/s)";
+    if (hdf5_out)
+        cout << ", stored " << stored / (1 << 20) << " MiB, compression ratio " << mib / (stored / (1 << 20));
+    cout << endl;
+
+    return 0;
+}
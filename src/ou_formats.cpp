@@ -0,0 +1,295 @@
+#include "ou_formats.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <iterator>
+#include <ostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+void write_text_header(ostream& file, const ou_header& header)
+{
+    // Every number is written in the shortest form that reads back to the same double
+    char number[32];
+    auto put = [&](double x, char sep) {
+        auto end = to_chars(number, number + sizeof(number) - 1, x).ptr;
+        *end++ = sep;
+        file.write(number, end - number);
+    };
+    file << "# paths steps dt theta mu sigma\n";
+    file << header.path_count << " " << header.step_count << " ";
+    put(header.dt, ' ');
+    put(header.theta, ' ');
+    put(header.mu, ' ');
+    put(header.sigma, '\n');
+    file << "# data\n";
+}
+
+bool read_text_header(istream& file, ou_header& header)
+{
+    string comment;
+    getline(file, comment);
+    file >> header.path_count >> header.step_count >> header.dt >> header.theta >> header.mu >> header.sigma;
+    file >> ws;
+    getline(file, comment);
+    return (bool)file;
+}
+
+void format_text_rows(const double* values, size_t rows, size_t cols, vector<char>& out)
+{
+    const size_t max_chars = 25;  // "-2.2250738585072014e-308" and a separator
+    out.resize(rows * (cols * max_chars + 1));
+    char* p = out.data();
+    for (size_t i = 0; i < rows; ++i)
+    {
+        const double* row = values + i * cols;
+        for (size_t j = 0; j < cols; ++j)
+        {
+            p = to_chars(p, p + max_chars, row[j]).ptr;
+            *p++ = ' ';
+        }
+        *p++ = '\n';
+    }
+    out.resize(p - out.data());
+}
+
+bool parse_text_values(const char* p, const char* end, double* values, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        while (p < end && (*p == ' ' || *p == '\n'))
+            ++p;
+        auto result = from_chars(p, end, values[i]);
+        if (result.ec != errc())
+            return false;
+        p = result.ptr;
+    }
+    return true;
+}
+
+bool write_text
+(
+    const string&         file_name,
+    const vector<double>& ou_process,
+    const ou_header&      header,
+    const size_t&         thread_count
+)
+{
+    ofstream file(file_name, ios::out | ios::binary);
+    write_text_header(file, header);
+
+    // Format blocks of rows (a few MiB of text each) in parallel into a ring of
+    // buffers, and write them in order as they become ready
+    auto block_rows = max<size_t>(1, (4 << 20) / (25 * max<size_t>(1, header.step_count)));
+    auto block_count = (header.path_count + block_rows - 1) / block_rows;
+
+    thread_pool formatters(thread_count);
+    vector<vector<char>> buffers(2 * formatters.size());
+    deque<future<void>> pending;
+    auto format_block = [&](size_t b) {
+        auto first = b * block_rows, last = min(header.path_count, first + block_rows);
+        format_text_rows(&ou_process[first * header.step_count], last - first, header.step_count,
+                         buffers[b % buffers.size()]);
+    };
+    auto write_front = [&](size_t done) {
+        pending.front().get();
+        pending.pop_front();
+        file.write(buffers[done % buffers.size()].data(), buffers[done % buffers.size()].size());
+    };
+
+    for (size_t b = 0; b < block_count; ++b)
+    {
+        if (pending.size() == buffers.size())
+            write_front(b - pending.size());
+        pending.push_back(formatters.submit([&, b] { format_block(b); }));
+    }
+    for (auto done = block_count - pending.size(); !pending.empty(); ++done)
+        write_front(done);
+
+    file.flush();
+    if (!file.good())
+    {
+        cerr << "Cannot write " << file_name << endl;
+        return false;
+    }
+    return true;
+}
+
+bool read_text(const string& file_name, vector<double>& ou_process, ou_header& header)
+{
+    ifstream file(file_name);
+    if (!read_text_header(file, header))
+        return false;
+
+    // Parse the rest of the file in one go; from_chars is much faster than operator>>
+    string text{istreambuf_iterator<char>(file), istreambuf_iterator<char>()};
+    ou_process.resize(header.path_count * header.step_count);
+    return parse_text_values(text.data(), text.data() + text.size(), ou_process.data(), ou_process.size());
+}
+
+static const char binary_magic[8] = {'\x89', 'O', 'U', 'B', 'I', 'N', '\r', '\n'};
+static const uint32_t binary_endianness = 0x01020304;
+static_assert(sizeof(ou_binary_header) == 128, "the binary header must stay 128 bytes");
+
+// Writes all of `buf` at `offset` (pwrite may write less than asked)
+static bool pwrite_all(int fd, const void* buf, size_t size, off_t offset)
+{
+    auto p = (const char*)buf;
+    while (size > 0)
+    {
+        auto n = pwrite(fd, p, min<size_t>(size, 1 << 30), offset);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        p += n;
+        size -= n;
+        offset += n;
+    }
+    return true;
+}
+
+binary_writer::~binary_writer()
+{
+    close();
+}
+
+bool binary_writer::open(const string& file_name, const ou_header& header)
+{
+    close();
+
+    ou_binary_header h{};
+    memcpy(h.magic, binary_magic, sizeof(h.magic));
+    h.version = 1;
+    h.endianness = binary_endianness;
+    h.path_count = header.path_count;
+    h.step_count = header.step_count;
+    h.dt = header.dt;
+    h.theta = header.theta;
+    h.mu = header.mu;
+    h.sigma = header.sigma;
+    h.data_offset = 4096;
+    header_ = header;
+    data_offset_ = h.data_offset;
+
+    // Size the file first, so that the file system can allocate it in one piece
+    fd_ = ::open(file_name.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    auto data_size = sizeof(double) * header.path_count * header.step_count;
+    if (fd_ < 0 || ftruncate(fd_, h.data_offset + data_size) != 0 || !pwrite_all(fd_, &h, sizeof(h), 0))
+    {
+        cerr << "Cannot write " << file_name << ": " << strerror(errno) << endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool binary_writer::write_rows(size_t first, const double* values, size_t rows)
+{
+    auto row_bytes = sizeof(double) * header_.step_count;
+    if (fd_ < 0 || !pwrite_all(fd_, values, rows * row_bytes, data_offset_ + first * row_bytes))
+    {
+        cerr << "Cannot write rows " << first << " to " << first + rows << ": " << strerror(errno) << endl;
+        return false;
+    }
+    return true;
+}
+
+void binary_writer::close()
+{
+    if (fd_ >= 0)
+        ::close(fd_);
+    fd_ = -1;
+}
+
+bool write_binary(const string& file_name, const vector<double>& ou_process, const ou_header& header)
+{
+    binary_writer writer;
+    return writer.open(file_name, header) && writer.write_rows(0, ou_process.data(), header.path_count);
+}
+
+bool read_binary(const string& file_name, vector<double>& ou_process, ou_header& header)
+{
+    binary_paths paths;
+    if (!paths.open(file_name))
+        return false;
+    header = paths.header();
+    ou_process.assign(paths.data(), paths.data() + paths.rows() * paths.cols());
+    return true;
+}
+
+binary_paths::~binary_paths()
+{
+    close();
+}
+
+bool binary_paths::open(const string& file_name)
+{
+    close();
+    error_.clear();
+
+    auto fd = ::open(file_name.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0)
+    {
+        error_ = "cannot open " + file_name + ": " + strerror(errno);
+        if (fd >= 0)
+            ::close(fd);
+        return false;
+    }
+    map_size_ = st.st_size;
+    map_ = (map_size_ >= sizeof(ou_binary_header)) ? mmap(NULL, map_size_, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);  // the mapping keeps the file open
+    if (map_ == MAP_FAILED)
+    {
+        map_ = nullptr;
+        error_ = file_name + " is too short or cannot be mapped";
+        return false;
+    }
+
+    ou_binary_header h;
+    memcpy(&h, map_, sizeof(h));
+    if (memcmp(h.magic, binary_magic, sizeof(h.magic)) != 0)
+        error_ = file_name + " is not an OU binary file";
+    else if (h.version != 1)
+        error_ = file_name + " has version " + to_string(h.version) + " of the binary format; we know version 1";
+    else if (h.endianness != binary_endianness)
+        error_ = file_name + " was written with the other byte order";
+    else if (h.data_offset % 4096 != 0 || h.data_offset > map_size_ ||
+             (map_size_ - h.data_offset) / sizeof(double) / max<uint64_t>(1, h.step_count) < h.path_count)
+        error_ = file_name + " is truncated";
+    if (!error_.empty())
+    {
+        close();
+        return false;
+    }
+
+    header_ = {h.path_count, h.step_count, h.dt, h.theta, h.mu, h.sigma};
+    data_ = (const double*)((const char*)map_ + h.data_offset);
+    madvise(map_, map_size_, MADV_SEQUENTIAL);
+    return true;
+}
+
+void binary_paths::close()
+{
+    if (map_)
+        munmap(map_, map_size_);
+    map_ = nullptr;
+    map_size_ = 0;
+    data_ = nullptr;
+    header_ = {};
+}
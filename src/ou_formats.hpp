@@ -0,0 +1,166 @@
+#ifndef OU_FORMATS_HPP
+#define OU_FORMATS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// The parameters of a set of sample paths, as recorded by the writers below
+struct ou_header
+{
+    size_t path_count;
+    size_t step_count;
+    double dt;
+    double theta;
+    double mu;
+    double sigma;
+};
+
+// Writes the paths (row-major, one row per path) as text: a commented line of
+// parameter names, their values, and then one path per line
+//
+// Numbers are written in the shortest form that reads back exactly. Blocks of
+// rows are formatted on `thread_count` threads (0 = one per hardware thread)
+// and written in order. Returns false if the file cannot be written.
+extern bool write_text
+(
+    const std::string&         file_name,
+    const std::vector<double>& ou_process,
+    const ou_header&           header,
+    const size_t&              thread_count
+);
+
+// Reads a file written by `write_text`; returns false if it cannot
+extern bool read_text
+(
+    const std::string&   file_name,
+    std::vector<double>& ou_process,
+    ou_header&           header
+);
+
+// The pieces of `write_text` and `read_text`, for writing and reading the
+// text format a block of rows at a time
+extern void write_text_header(std::ostream& file, const ou_header& header);
+extern bool read_text_header(std::istream& file, ou_header& header);
+
+// Formats `rows` rows of `cols` values into `out` (which is resized to the text)
+extern void format_text_rows(const double* values, size_t rows, size_t cols, std::vector<char>& out);
+
+// Parses `count` values from [p, end); returns false if there are fewer
+extern bool parse_text_values(const char* p, const char* end, double* values, size_t count);
+
+// The header of the binary format, which occupies the first 128 bytes of the file
+//
+// All fields are in the byte order of the machine that wrote the file, which
+// `endianness` (0x01020304 as written) records. The paths follow at byte
+// `data_offset`, a multiple of 4096, so that a mapping of the file has them
+// page-aligned; they are row-major doubles, one row per path.
+struct ou_binary_header
+{
+    char     magic[8];        // "\x89OUBIN\r\n"
+    uint32_t version;         // 1
+    uint32_t endianness;      // 0x01020304
+    uint64_t path_count;
+    uint64_t step_count;
+    double   dt;
+    double   theta;
+    double   mu;
+    double   sigma;
+    uint64_t data_offset;
+    uint64_t reserved[7];     // zero
+};
+
+// Writes the header and then the paths with pwrite; returns false on an error
+extern bool write_binary
+(
+    const std::string&         file_name,
+    const std::vector<double>& ou_process,
+    const ou_header&           header
+);
+
+// Writes the binary format a block of rows at a time, in any order
+class binary_writer
+{
+public:
+    binary_writer() = default;
+    ~binary_writer();
+
+    binary_writer(const binary_writer&) = delete;
+    binary_writer& operator=(const binary_writer&) = delete;
+
+    // Creates `file_name` with room for all the paths of `header`
+    bool open(const std::string& file_name, const ou_header& header);
+
+    // Writes rows [first, first + rows)
+    bool write_rows(size_t first, const double* values, size_t rows);
+
+    void close();
+
+private:
+    int       fd_ = -1;
+    ou_header header_{};
+    uint64_t  data_offset_ = 0;
+};
+
+// Reads a file written by `write_binary` into memory; returns false if it cannot
+extern bool read_binary
+(
+    const std::string&   file_name,
+    std::vector<double>& ou_process,
+    ou_header&           header
+);
+
+// Maps a file written by `write_binary` and exposes its paths in place
+//
+// `open` checks the magic number, the version, the byte order, and the size
+// of the file. The view is read-only and valid until `close` (or destruction).
+class binary_paths
+{
+public:
+    binary_paths() = default;
+    ~binary_paths();
+
+    binary_paths(const binary_paths&) = delete;
+    binary_paths& operator=(const binary_paths&) = delete;
+
+    // Maps `file_name`; returns false (with the reason in `error()`) if it cannot
+    bool open(const std::string& file_name);
+    void close();
+
+    const ou_header&   header() const { return header_; }
+    const std::string& error() const { return error_; }
+
+    size_t        rows() const { return header_.path_count; }
+    size_t        cols() const { return header_.step_count; }
+    const double* data() const { return data_; }
+    const double* row(size_t i) const { return data_ + i * header_.step_count; }
+    double        operator()(size_t i, size_t j) const { return data_[i * header_.step_count + j]; }
+
+private:
+    void*       map_ = nullptr;
+    size_t      map_size_ = 0;
+    const double* data_ = nullptr;
+    ou_header   header_{};
+    std::string error_;
+};
+
+// Writes the paths to the contiguous two-dimensional dataset `/dataset` and
+// the parameters to attributes of it (in ou_formats_hdf5.cpp, which needs HDF5)
+extern void write_hdf5
+(
+    const std::string&         file_name,
+    const std::vector<double>& ou_process,
+    const ou_header&           header
+);
+
+// Reads a file written by `write_hdf5`; returns false if it cannot
+extern bool read_hdf5
+(
+    const std::string&   file_name,
+    std::vector<double>& ou_process,
+    ou_header&           header
+);
+
+#endif
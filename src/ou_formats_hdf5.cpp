@@ -0,0 +1,74 @@
+#include "ou_formats.hpp"
+#include "docstring.hpp"
+
+#include "hdf5.h"
+
+using namespace std;
+
+void write_hdf5(const string& file_name, const vector<double>& ou_process, const ou_header& header)
+{
+    auto file = H5Fcreate(file_name.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+
+    hsize_t dimsf[] = {(hsize_t)header.path_count, (hsize_t)header.step_count};
+    auto space = H5Screate_simple(2, dimsf, NULL);
+    auto dataset = H5Dcreate(file, "/dataset", H5T_NATIVE_DOUBLE, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    H5Dwrite(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, ou_process.data());
+    H5Dclose(dataset);
+    H5Sclose(space);
+
+    add_docstring(file, "dataset", "rows", "path");
+    add_docstring(file, "dataset", "columns", "time");
+
+    auto scalar = H5Screate(H5S_SCALAR);
+    auto acpl = H5Pcreate(H5P_ATTRIBUTE_CREATE);
+    H5Pset_char_encoding(acpl, H5T_CSET_UTF8);
+    auto set_attribute = [&](const string& name, const double& value) {
+        auto attr = H5Acreate_by_name(file, "dataset", name.c_str(), H5T_NATIVE_DOUBLE, scalar, acpl, H5P_DEFAULT, H5P_DEFAULT);
+        H5Awrite(attr, H5T_NATIVE_DOUBLE, &value);
+        H5Aclose(attr);
+    };
+    set_attribute("dt", header.dt);
+    set_attribute("θ", header.theta);
+    set_attribute("μ", header.mu);
+    set_attribute("σ", header.sigma);
+    H5Pclose(acpl);
+    H5Sclose(scalar);
+
+    H5Fclose(file);
+}
+
+bool read_hdf5(const string& file_name, vector<double>& ou_process, ou_header& header)
+{
+    auto file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (file < 0)
+        return false;
+    auto dataset = H5Dopen(file, "/dataset", H5P_DEFAULT);
+    auto space = H5Dget_space(dataset);
+    hsize_t dims[2] = {0, 0};
+    H5Sget_simple_extent_dims(space, dims, NULL);
+    header.path_count = dims[0];
+    header.step_count = dims[1];
+
+    auto get_attribute = [&](const string& key) {
+        double value = 0.0;
+        if (H5Aexists_by_name(file, "dataset", key.c_str(), H5P_DEFAULT) > 0)
+        {
+            auto attr = H5Aopen_by_name(file, "dataset", key.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+            H5Aread(attr, H5T_NATIVE_DOUBLE, &value);
+            H5Aclose(attr);
+        }
+        return value;
+    };
+    header.dt = get_attribute("dt");
+    header.theta = get_attribute("θ");
+    header.mu = get_attribute("μ");
+    header.sigma = get_attribute("σ");
+
+    ou_process.resize(header.path_count * header.step_count);
+    auto status = H5Dread(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, ou_process.data());
+
+    H5Sclose(space);
+    H5Dclose(dataset);
+    H5Fclose(file);
+    return status >= 0;
+}
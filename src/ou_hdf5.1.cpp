@@ -1,24 +1,40 @@
 #include "parse_arguments1.hpp"
+#include "docstring.hpp"
 #include "ou_sampler1.hpp"
+#include "chunk_writer.hpp"
+#include "appender.hpp"
+#include "batch_queue.hpp"
 
 #include "hdf5.h"
+#include <chrono>
+#include <memory>
+#include <thread>
 #include <vector>
 
 using namespace std;
 
 int main(int argc, char *argv[])
 {
-    size_t path_count, batch_size;
+    size_t path_count, batch_size, first_path;
     double dt, theta, mu, sigma;
+    uint64_t seed;
+    uint32_t stream;
+    storage_options1 storage;
 
     argparse::ArgumentParser program("ou_hdf5.1");
     set_options1(program);
+    set_storage_options1(program);
     program.parse_args(argc, argv);
-    get_arguments1(program, path_count, batch_size, dt, theta, mu, sigma);
+    if (get_arguments1(program, path_count, batch_size, dt, theta, mu, sigma, seed, stream, first_path) < 0 ||
+        get_storage_options1(program, storage) < 0)
+        return 1;
 
     cout << "Running with parameters:"
          << " paths=" << path_count << " batch=" << batch_size
-         << " dt=" << dt << " theta=" << theta << " mu=" << mu << " sigma=" << sigma << endl;
+         << " dt=" << dt << " theta=" << theta << " mu=" << mu << " sigma=" << sigma
+         << " seed=" << seed << " stream=" << stream << " first_path=" << first_path
+         << " shuffle=" << storage.shuffle << " deflate=" << storage.deflate << " direct=" << storage.direct
+         << " buffers=" << storage.buffer_count << endl;
 
     auto file = H5Fcreate("ou_process.1.h5", H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
     hid_t paths, descr;
@@ -26,12 +42,17 @@ int main(int argc, char *argv[])
     auto lcpl = H5Pcreate(H5P_LINK_CREATE);
     H5Pset_create_intermediate_group(lcpl, 1);
 
+    const size_t chunk_size = 128 * 1024;
     { // create the extendible `paths/data` dataset
         hsize_t dimsf[] = {0, H5S_UNLIMITED};
         auto space = H5Screate_simple(1, dimsf, &dimsf[1]);
         auto dcpl = H5Pcreate(H5P_DATASET_CREATE);
-        hsize_t cdims[] = {128 * 1024};
+        hsize_t cdims[] = {chunk_size};
         H5Pset_chunk(dcpl, 1, cdims);
+        if (storage.shuffle)
+            H5Pset_shuffle(dcpl);
+        if (storage.deflate > 0)
+            H5Pset_deflate(dcpl, storage.deflate);
         paths = H5Dcreate(file, "/paths/data", H5T_NATIVE_DOUBLE, space, lcpl, dcpl, H5P_DEFAULT);
         H5Pclose(dcpl);
         H5Sclose(space);
@@ -45,59 +66,95 @@ int main(int argc, char *argv[])
     
     H5Pclose(lcpl);
 
-    // vectors to store the paths and the descriptors in a batch
-    vector<double> ou_process;
-    vector<hsize_t> offset;
-
-    // track the global (=across batches) offset
-    hsize_t global_pos = 0;  // 
+    // a batch of paths and their descriptors
+    struct batch
+    {
+        vector<double>  ou_process;
+        vector<hsize_t> offset;
+    };
+
+    // the appenders track the extents and reuse their dataspaces across batches
+    appender path_out(paths, H5T_NATIVE_DOUBLE), descr_out(descr, H5T_NATIVE_HSIZE);
+
+    // the workers sample the paths and, with --direct, run the filter pipeline
+    thread_pool workers(storage.thread_count);
+    unique_ptr<chunk_writer> direct;
+    if (storage.direct)
+        direct = make_unique<chunk_writer>(paths, chunk_size, storage.shuffle, storage.deflate, workers);
+
+    // Producer/consumer pipeline: we sample batches into free buffers and hand
+    // them to the I/O thread, which appends them and hands the buffers back.
+    // Each buffer keeps its capacity, so after the first few batches nothing is allocated.
+    vector<batch> buffers(storage.buffer_count);
+    batch_queue<batch*> empty(buffers.size()), full(buffers.size());
+    for (auto& b : buffers)
+        empty.push(&b);
+
+    using clock = chrono::steady_clock;
+    auto started = clock::now();
+    chrono::duration<double> writing{0};
+
+    thread writer([&] {
+        batch* b = nullptr;
+        while (full.pop(b))
+        {
+            auto t = clock::now();
+
+            // the offsets are 0-based and we must correct this for the global (=across batches) offset
+            hsize_t global_pos = path_out.size();
+            std::for_each(b->offset.begin(), b->offset.end(), [&](hsize_t &n){ n+=global_pos; });
+
+            // write the paths and the path descriptors with one call
+            write_batch writes;
+            if (direct)
+            {
+                // the chunk writer carries partial chunks over to the next batch
+                path_out.grow(b->ou_process.size());
+                direct->append(b->ou_process.data(), b->ou_process.size());
+            }
+            else
+                path_out.append(b->ou_process.data(), b->ou_process.size(), writes);
+            descr_out.append(b->offset.data(), b->offset.size() - 1, writes);  // offset has one extra element
+            writes.flush();
+
+            writing += clock::now() - t;
+            empty.push(b);
+        }
+    });
 
     for (size_t p = 0; p < path_count; p += batch_size)
     {
         if (p + batch_size > path_count)  // last batch
             batch_size = path_count - p;
         cout << "Generating paths " << p << " to " << p + batch_size << endl;
-        
-        // Generate a batch of paths and offsets
-        ou_sampler1(ou_process, offset, batch_size, dt, theta, mu, sigma);
-
-        { // write the paths
-            auto path_space = H5Dget_space(paths);
-            hsize_t path_elem_count = (hsize_t) H5Sget_simple_extent_npoints(path_space);  // 1D dataset
-            H5Sclose(path_space);
-            hsize_t path_dims[] = {path_elem_count + (hsize_t) ou_process.size()};
-
-            // make room for more data
-            H5Dset_extent(paths, path_dims);   
-            // get the updated dataspace to make the correct selection(!)
-            path_space = H5Dget_space(paths);
-
-            hsize_t start[] = {path_elem_count};
-            hsize_t count[] = {(hsize_t) ou_process.size()};
-            H5Sselect_hyperslab(path_space, H5S_SELECT_SET, start, NULL, count, NULL);
-            auto mem_space = H5Screate_simple(1, count, NULL);
-            H5Sselect_all(mem_space);  // we want to write the whole vector
-            H5Dwrite(paths, H5T_NATIVE_DOUBLE, mem_space, path_space, H5P_DEFAULT, ou_process.data());
-            H5Sclose(mem_space);
-            H5Sclose(path_space);
-        }
-        { // write the path descriptors
-            auto descr_space = H5Dget_space(descr);
-            hsize_t start[] = { (hsize_t) p };
-            hsize_t count[] = { (hsize_t) offset.size()-1};  // offset has one extra element
-            H5Sselect_hyperslab(descr_space, H5S_SELECT_SET, start, NULL, count, NULL);
-            auto mem_space = H5Screate_simple(1, count, NULL);
-            H5Sselect_all(mem_space);
-            // the offsets are 0-based and we must correct this for the global offset
-            std::for_each(offset.begin(), offset.end(), [&](hsize_t &n){ n+=global_pos; });
-            global_pos = offset.back();
-            H5Dwrite(descr, H5T_NATIVE_HSIZE, mem_space, descr_space, H5P_DEFAULT, offset.data());
-            H5Sclose(mem_space);
-            H5Sclose(descr_space);
-        }
+
+        batch* b = nullptr;
+        empty.pop(b);
+        ou_sampler1(b->ou_process, b->offset, batch_size, dt, theta, mu, sigma, seed, stream, first_path + p, workers);
+        full.push(b);
     }
-    
+    full.close();
+    writer.join();
+
+    auto t = clock::now();
+    if (direct)
+        direct->close();
+    path_out.close();
+    descr_out.close();
+    H5Dflush(paths);  // chunks still in the cache count as write time
+    writing += clock::now() - t;
+    chrono::duration<double> total = clock::now() - started;
+
+    // Report the throughput and who waited for whom: the sampler stalls when all
+    // buffers are queued for writing, the writer when none is ready yet
+    double mib = (double)path_out.size() * sizeof(double) / (1 << 20);
+    cout << "Wrote " << mib << " MiB in " << total.count() << " s (" << mib / total.count() << " MiB/s overall, "
+         << mib / writing.count() << " MiB/s while writing), sampler stalled " << empty.waited().count()
+         << " s, writer stalled " << full.waited().count() << " s" << endl;
+
     { // make the file self-describing by adding a few attributes to `paths`
+        add_rng_docstrings(file, "paths", seed, stream, first_path);
+
         auto scalar = H5Screate(H5S_SCALAR);
         auto acpl = H5Pcreate(H5P_ATTRIBUTE_CREATE);
         H5Pset_char_encoding(acpl, H5T_CSET_UTF8);
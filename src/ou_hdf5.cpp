@@ -1,24 +1,59 @@
+#include "parse_arguments.hpp"
+#include "hdf5_options.hpp"
+#include "bitround.hpp"
 #include "docstring.hpp"
 #include "ou_sampler.hpp"
+#include "thread_pool.hpp"
 
 #include "hdf5.h"
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <vector>
 
 using namespace std;
 
-int main()
+int main(int argc, char *argv[])
 {
-    const size_t path_count = 100, step_count = 1000;
-    const double dt = 0.01, theta = 1.0, mu = 0.0, sigma = 0.1;
+    size_t path_count, step_count, first_path;
+    double dt, theta, mu, sigma;
+    uint64_t seed;
+    uint32_t stream;
+
+    hdf5_options options;
+
+    argparse::ArgumentParser program("ou_hdf5");
+    set_options(program);
+    set_hdf5_options(program);
+    program.parse_args(argc, argv);
+    if (get_arguments(program, path_count, step_count, dt, theta, mu, sigma, seed, stream, first_path) < 0 ||
+        get_hdf5_options(program, options) < 0)
+        return 1;
+
+    // Paths are generated and written in blocks, so memory use is bounded by two blocks
+    size_t block_rows = options.block_rows;
+    if (block_rows == 0)
+        block_rows = max<size_t>(1, (64 << 20) / (sizeof(double) * step_count));
+    // Blocks of whole chunks never leave a chunk half-written, which would
+    // force HDF5 to read, decompress, and recompress it for the next block
+    hsize_t chunk[2];
+    chunk_shape(options, path_count, step_count, chunk);
+    if (chunk[0] > 0)
+        block_rows = (block_rows + chunk[0] - 1) / chunk[0] * chunk[0];
+    block_rows = min(block_rows, path_count);
 
     cout << "Running with parameters:"
          << " paths=" << path_count << " steps=" << step_count
-         << " dt=" << dt << " theta=" << theta << " mu=" << mu << " sigma=" << sigma << endl;
+         << " dt=" << dt << " theta=" << theta << " mu=" << mu << " sigma=" << sigma
+         << " seed=" << seed << " stream=" << stream << " first_path=" << first_path
+         << " block=" << block_rows;
+    if (chunk[0] > 0)
+        cout << " chunk=" << chunk[0] << "x" << chunk[1] << " shuffle=" << options.shuffle
+             << " deflate=" << options.deflate << " fletcher32=" << options.fletcher32;
+    if (!options.lossy.empty())
+        cout << " lossy=" << options.lossy << " error=" << options.error_bound;
+    cout << endl;
 
-    vector<double> ou_process;
-    ou_sampler(ou_process, path_count, step_count, dt, theta, mu, sigma);
-    
     //
     // Write the sample paths to an HDF5 file using the HDF5 C-API!
     //
@@ -27,11 +62,59 @@ int main()
 
     add_docstring(file, ".", "source", "https://github.com/HDFGroup/hdf5-tutorial");
 
-    { // create & write the dataset
+    { // create the dataset & write it one block of rows (= hyperslab) at a time
         hsize_t dimsf[] = {(hsize_t)path_count, (hsize_t)step_count};
         auto space = H5Screate_simple(2, dimsf, NULL);
-        auto dataset = H5Dcreate(file, "/dataset", H5T_NATIVE_DOUBLE, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
-        H5Dwrite(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, ou_process.data());
+        auto dcpl = make_dcpl(options, path_count, step_count);
+        auto dataset = H5Dcreate(file, "/dataset", H5T_NATIVE_DOUBLE, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+        H5Pclose(dcpl);
+
+        // Double buffering: a background thread samples the next block while we write this one
+        vector<double> ou_process[2];
+        thread_pool sampler(1), workers(options.thread_count);  // `workers` serve every block
+        auto sample = [&](size_t b, size_t row) {
+            auto rows = min(block_rows, path_count - row);
+            return sampler.submit([&, b, row, rows] {
+                ou_process[b].resize(rows * step_count);
+                ou_sampler(ou_process[b].data(), rows, step_count, dt, theta, mu, sigma, seed, stream, first_path + row, workers);
+                if (options.lossy == "bitround")
+                    bitround(ou_process[b].data(), ou_process[b].size(), bitround_keepbits(options.error_bound));
+            });
+        };
+
+        using clock = chrono::steady_clock;
+        auto started = clock::now();
+        chrono::duration<double> writing{0};
+
+        auto sampled = sample(0, 0);
+        for (size_t row = 0, b = 0; row < path_count; row += block_rows, b ^= 1)
+        {
+            sampled.get();  // block `b` is ready
+            if (row + block_rows < path_count)
+                sampled = sample(b ^ 1, row + block_rows);
+
+            hsize_t start[] = {(hsize_t)row, 0};
+            hsize_t count[] = {(hsize_t)min(block_rows, path_count - row), (hsize_t)step_count};
+            H5Sselect_hyperslab(space, H5S_SELECT_SET, start, NULL, count, NULL);
+            auto mem_space = H5Screate_simple(2, count, NULL);
+            auto t = clock::now();
+            H5Dwrite(dataset, H5T_NATIVE_DOUBLE, mem_space, space, H5P_DEFAULT, ou_process[b].data());
+            writing += clock::now() - t;
+            H5Sclose(mem_space);
+        }
+
+        auto t = clock::now();
+        H5Dflush(dataset);  // chunks still in the cache count as write time
+        writing += clock::now() - t;
+        chrono::duration<double> total = clock::now() - started;
+
+        // Report the throughput (of the H5Dwrite calls and overall) and the compression ratio
+        double mib = (double)path_count * step_count * sizeof(double) / (1 << 20);
+        double stored = (double)H5Dget_storage_size(dataset) / (1 << 20);
+        cout << "Wrote " << mib << " MiB in " << total.count() << " s (" << mib / total.count() << " MiB/s overall, "
+             << mib / writing.count() << " MiB/s in H5Dwrite), stored " << stored << " MiB, compression ratio "
+             << mib / stored << endl;
+
         H5Dclose(dataset);
         H5Sclose(space);
     }
@@ -41,6 +124,8 @@ int main()
         add_docstring(file, "dataset", "Wikipedia", "https://en.wikipedia.org/wiki/Ornstein%E2%80%93Uhlenbeck_process");
         add_docstring(file, "dataset", "rows", "path");
         add_docstring(file, "dataset", "columns", "time");
+        add_rng_docstrings(file, "dataset", seed, stream, first_path);
+        add_lossy_attributes(file, "dataset", options);
         
         auto scalar = H5Screate(H5S_SCALAR);
         auto acpl = H5Pcreate(H5P_ATTRIBUTE_CREATE);
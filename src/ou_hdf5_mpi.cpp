@@ -1,15 +1,227 @@
 #include "parse_arguments.hpp"
 #include "parse_arguments2.hpp"
+#include "hdf5_options.hpp"
 #include "partitioner.hpp"
+#include "mpi_options.hpp"
+#include "rank_timing.hpp"
 #include "docstring.hpp"
+#include "attribute_batch.hpp"
 #include "ou_sampler.hpp"
+#include "thread_pool.hpp"
+#include "bitround.hpp"
 
 #include "hdf5.h"
+#include <mpi.h>
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
+#include <numeric>
+#include <thread>
 #include <vector>
 
 using namespace std;
 
+// Prints (on rank 0) how many chunks of `chunk` the ranks share; several ranks
+// writing one chunk serialize on it and, with filters, read-modify-write it
+static void report_contention
+(
+    const vector<path_range>& ranges,
+    const size_t&             path_count,
+    const size_t&             step_count,
+    const hsize_t             chunk[2],
+    MPI_Comm                  comm
+)
+{
+    int rank, nranks;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &nranks);
+
+    // The chunks are counted in bands of `chunk[0]` rows; a band holds this many chunks
+    hsize_t band = (step_count + chunk[1] - 1) / chunk[1];
+    unsigned long touched = chunks_touched(ranges, chunk[0]);
+    auto shared = shared_chunks(ranges, path_count, chunk[0]);
+
+    int my_count = (int)shared.size();
+    vector<int> counts(rank == 0 ? nranks : 0), displs(rank == 0 ? nranks : 0);
+    vector<unsigned long> all_touched(rank == 0 ? nranks : 0);
+    MPI_Gather(&touched, 1, MPI_UNSIGNED_LONG, all_touched.data(), 1, MPI_UNSIGNED_LONG, 0, comm);
+    MPI_Gather(&my_count, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, comm);
+    vector<unsigned long> mine(shared.begin(), shared.end()), all;
+    if (rank == 0)
+    {
+        for (int r = 1; r < nranks; ++r)
+            displs[r] = displs[r - 1] + counts[r - 1];
+        all.resize(displs.back() + counts.back());
+    }
+    MPI_Gatherv(mine.data(), my_count, MPI_UNSIGNED_LONG, all.data(), counts.data(), displs.data(), MPI_UNSIGNED_LONG, 0, comm);
+    if (rank != 0)
+        return;
+
+    // Every rank lists a shared band once, so a band's multiplicity is its number of writers
+    sort(all.begin(), all.end());
+    size_t shared_bands = 0, max_writers = 0;
+    for (size_t i = 0; i < all.size();)
+    {
+        size_t j = i;
+        while (j < all.size() && all[j] == all[i])
+            ++j;
+        ++shared_bands;
+        max_writers = max(max_writers, j - i);
+        i = j;
+    }
+    auto [lo, hi] = minmax_element(all_touched.begin(), all_touched.end());
+    size_t bands = (path_count + chunk[0] - 1) / chunk[0];
+
+    cout << "Chunks: " << bands * band << " of " << chunk[0] << "x" << chunk[1]
+         << ", " << *lo * band << " to " << *hi * band << " per rank, "
+         << shared_bands * band << " (" << 100.0 * shared_bands / bands << "%) shared";
+    if (shared_bands > 0)
+        cout << " by up to " << max_writers << " ranks";
+    cout << endl;
+}
+
+// Creates `/dataset` with the layout and filters of `options`
+static hid_t create_dataset(hid_t file, const hdf5_options& options, const size_t& path_count, const size_t& step_count)
+{
+    hsize_t dimsf[] = {(hsize_t)path_count, (hsize_t)step_count};
+    auto filespace = H5Screate_simple(2, dimsf, NULL);
+    // Every element is written, so skip writing fill values first
+    auto dcpl = make_dcpl(options, path_count, step_count);
+    H5Pset_fill_time(dcpl, H5D_FILL_TIME_NEVER);
+    auto dataset = H5Dcreate(file, "/dataset", H5T_NATIVE_DOUBLE, filespace, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    H5Pclose(dcpl);
+    H5Sclose(filespace);
+    return dataset;
+}
+
+// Writes the rows of `ranges`, stored one after the other in `ou_process`,
+// collectively or independently
+static void write_paths
+(
+    hid_t                     dataset,
+    const vector<path_range>& ranges,
+    const size_t&             step_count,
+    const vector<double>&     ou_process,
+    H5FD_mpio_xfer_t          transfer
+)
+{
+    // Define, by rank, a selection in memory and write it to a hyperslab in the file.
+    hsize_t dimsm[] = {ou_process.size() / step_count, step_count};
+    hid_t memspace = H5Screate_simple(2, dimsm, NULL);
+
+    // Select the union of the rank's ranges in the file; a rank without
+    // paths selects nothing, but still takes part in the collective write
+    hid_t filespace = H5Dget_space(dataset);
+    H5Sselect_none(filespace);
+    for (auto& range : ranges)
+    {
+        hsize_t count[]  = {range.size(), step_count};
+        hsize_t offset[] = {range.first, 0};
+        H5Sselect_hyperslab(filespace, H5S_SELECT_OR, offset, NULL, count, NULL);
+    }
+    if (ou_process.empty())
+        H5Sselect_none(memspace);
+
+    // <OPTIONAL> Create property list for collective dataset write.
+    hid_t dxpl = H5Pcreate(H5P_DATASET_XFER);
+    H5Pset_dxpl_mpio(dxpl, transfer);
+
+    H5Dwrite(dataset, H5T_NATIVE_DOUBLE, memspace, filespace, dxpl, ou_process.data());
+
+    // housekeeping
+    H5Pclose(dxpl);
+    H5Sclose(filespace);
+    H5Sclose(memspace);
+}
+
+// Writes the same paths with MPI-IO and with every combination of the
+// subfiling settings, and prints (on rank 0) the time from creating to
+// closing the file of the slowest rank and the resulting bandwidth
+static void sweep_drivers
+(
+    const hdf5_options&       options,
+    const mpi_io_options&     io_options,
+    const size_t&             path_count,
+    const size_t&             step_count,
+    const vector<path_range>& ranges,
+    const vector<double>&     ou_process
+)
+{
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    const char* file_name = "ou_process.sweep.h5";
+    double mib = (double)path_count * step_count * sizeof(double) / (1 << 20);
+
+    if (rank == 0)
+        printf("%-10s %12s %10s %12s %10s %10s\n", "driver", "stripe size", "IOCs/node", "IOC threads", "time s", "MiB/s");
+
+    // -1 stands for MPI-IO, which ignores the subfiling settings
+    struct setting { hsize_t stripe_size; int iocs_per_node; int ioc_threads; };
+    vector<setting> settings = {{0, -1, 0}};
+#ifdef H5_HAVE_SUBFILING_VFD
+    for (auto stripe_size : io_options.stripe_sizes)
+        for (auto iocs_per_node : io_options.iocs_per_node)
+            for (auto ioc_threads : io_options.ioc_threads)
+                settings.push_back({stripe_size, iocs_per_node, ioc_threads});
+#else
+    if (rank == 0)
+        printf("(this HDF5 library has no subfiling driver, so only MPI-IO is measured)\n");
+#endif
+
+    for (auto& s : settings)
+    {
+        hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+        auto info = make_mpi_info(io_options);
+#ifdef H5_HAVE_SUBFILING_VFD
+        if (s.iocs_per_node >= 0)
+            set_fapl_subfiling(fapl, s.stripe_size, s.iocs_per_node, s.ioc_threads);
+        else
+#endif
+            H5Pset_fapl_mpio(fapl, MPI_COMM_WORLD, info);
+        set_fapl_alignment(fapl, io_options);
+        set_fapl_metadata(fapl, io_options);
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        auto start = MPI_Wtime();
+        auto fcpl = make_fcpl(io_options);
+        auto file = H5Fcreate(file_name, H5F_ACC_TRUNC, fcpl, fapl);
+        H5Pclose(fcpl);
+        auto dataset = create_dataset(file, options, path_count, step_count);
+        write_paths(dataset, ranges, step_count, ou_process,
+                    io_options.independent ? H5FD_MPIO_INDEPENDENT : H5FD_MPIO_COLLECTIVE);
+        H5Dclose(dataset);
+        H5Fclose(file);
+        double seconds = MPI_Wtime() - start, slowest = 0.0;
+        MPI_Reduce(&seconds, &slowest, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+        if (rank == 0)
+        {
+            auto setting_or_default = [](long long value) { return value > 0 ? to_string(value) : string("default"); };
+            printf("%-10s %12s %10s %12s %10.3f %10.1f\n", s.iocs_per_node < 0 ? "mpio" : "subfiling",
+                   s.iocs_per_node < 0 ? "-" : setting_or_default(s.stripe_size).c_str(),
+                   s.iocs_per_node < 0 ? "-" : setting_or_default(s.iocs_per_node).c_str(),
+                   s.iocs_per_node < 0 ? "-" : setting_or_default(s.ioc_threads).c_str(),
+                   slowest, mib / slowest);
+            fflush(stdout);
+        }
+
+        // Remove the file (and the subfiles) before the next setting
+        MPI_Barrier(MPI_COMM_WORLD);
+#if H5_VERSION_GE(1, 14, 0)
+        H5E_BEGIN_TRY {
+            H5Fdelete(file_name, fapl);
+        } H5E_END_TRY;
+#else
+        if (rank == 0)
+            MPI_File_delete(file_name, info);
+#endif
+        MPI_Barrier(MPI_COMM_WORLD);
+        if (info != MPI_INFO_NULL)
+            MPI_Info_free(&info);
+        H5Pclose(fapl);
+    }
+}
+
 int main(int argc, char *argv[])
 {
     // <ALTERNATIVE>:: The standard MPI IO File Driver only requires:
@@ -35,11 +247,16 @@ int main(int argc, char *argv[])
     int myid;
     MPI_Comm_rank(MPI_COMM_WORLD, &myid);
 
-    size_t path_count, step_count;
+    size_t path_count, step_count, first_path;
     double dt, theta, mu, sigma;
+    uint64_t seed;
+    uint32_t stream;
 #ifdef H5_HAVE_SUBFILING_VFD    
     bool subfiling;
 #endif    
+    hdf5_options options;
+    mpi_io_options io_options;
+    partition_options partition;
 
     argparse::ArgumentParser program("ou_hdf5_mpi");
 #ifdef H5_HAVE_SUBFILING_VFD
@@ -47,102 +264,251 @@ int main(int argc, char *argv[])
 #else
     set_options(program);
 #endif
+    set_hdf5_options(program);
+    set_mpi_io_options(program);
+    set_partition_options(program);
     program.parse_args(argc, argv);
 #ifdef H5_HAVE_SUBFILING_VFD
-    get_arguments2(program, path_count, step_count, dt, theta, mu, sigma, subfiling);
+    if (get_arguments2(program, path_count, step_count, dt, theta, mu, sigma, seed, stream, first_path, subfiling) < 0 ||
 #else
-    get_arguments(program, path_count, step_count, dt, theta, mu, sigma);
+    if (get_arguments(program, path_count, step_count, dt, theta, mu, sigma, seed, stream, first_path) < 0 ||
 #endif     
+        get_hdf5_options(program, options) < 0 ||
+        get_mpi_io_options(program, io_options) < 0 ||
+        get_partition_options(program, partition) < 0)
+    {
+        MPI_Finalize();
+        return 1;
+    }
+
+    if (program.is_used("--block"))
+    {
+        if (myid == 0)
+            cerr << "Every rank samples its paths at once; use --partition_block to choose the unit of division" << endl;
+        MPI_Finalize();
+        return 1;
+    }
+
+    // HDF5 writes filtered chunks only collectively; independent writers own
+    // whole chunks, so that no two ranks write the same chunk
+    if (io_options.independent && (options.shuffle || options.deflate > 0 || options.fletcher32 || options.lossy == "scaleoffset"))
+    {
+        if (myid == 0)
+            cerr << "Filtered datasets can only be written collectively" << endl;
+        MPI_Finalize();
+        return 1;
+    }
+    if (io_options.independent && !options.chunk.empty())
+        partition.align_chunks = true;
+
+    // With --align_chunks, pick the chunk height and the decomposition together:
+    // the ranks divide whole chunks, and chunks are no taller than a rank's share
+    hsize_t chunk[2];
+    chunk_shape(options, path_count, step_count, chunk);
+    if (partition.align_chunks)
+    {
+        if (chunk[0] == 0)
+        {
+            if (myid == 0)
+                cerr << "Aligning to chunks requires a chunked layout (--chunk)" << endl;
+            MPI_Finalize();
+            return 1;
+        }
+        chunk[0] = min<hsize_t>(chunk[0], (path_count + nprocs - 1) / nprocs);
+        options.chunk = to_string(chunk[0]) + "x" + to_string(chunk[1]);
+        partition.block = chunk[0];
+    }
+
+    // Each rank samples on a team of threads; by default, the ranks of a node
+    // share its hardware threads, so that one rank per node or socket can use
+    // them all. Only this thread calls HDF5 (and MPI).
+    size_t thread_count = options.thread_count;
+    int node_ranks;
+    {
+        MPI_Comm node;
+        MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, myid, MPI_INFO_NULL, &node);
+        MPI_Comm_size(node, &node_ranks);
+        MPI_Comm_free(&node);
+    }
+    if (thread_count == 0)
+        thread_count = max<size_t>(1, thread::hardware_concurrency() / node_ranks);
+
+    // All ranks must sample the same stream
+    MPI_Bcast(&seed, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
 
     if (myid == 0)
     {
         cout << "Running on " << nprocs << " MPI ranks with parameters:"
             << " paths=" << path_count << " steps=" << step_count
             << " dt=" << dt << " theta=" << theta << " mu=" << mu << " sigma=" << sigma
+            << " seed=" << seed << " stream=" << stream << " first_path=" << first_path
 #ifdef H5_HAVE_SUBFILING_VFD
             << " subfiling=" << subfiling
 #endif
             << endl;
+        cout << "Threads: " << thread_count << " sampler threads per rank, " << node_ranks << " ranks on the first node" << endl;
+        cout << "Partition: " << to_string(partition.scheme) << " in blocks of " << partition.block << " paths" << endl;
+        if (chunk[0] > 0)
+            cout << "Layout: chunks of " << chunk[0] << "x" << chunk[1] << " shuffle=" << options.shuffle
+                 << " deflate=" << options.deflate << " fletcher32=" << options.fletcher32
+                 << " lossy=" << (options.lossy.empty() ? "none" : options.lossy) << endl;
+        if (!io_options.hints.empty())
+        {
+            cout << "MPI-IO hints:";
+            for (auto& [key, value] : io_options.hints)
+                cout << " " << key << "=" << value;
+            cout << endl;
+        }
+        cout << "Transfer: " << (io_options.independent ? "independent" : "collective")
+             << ", metadata: " << (io_options.coll_metadata ? "collective" : "independent");
+        if (io_options.page_size > 0)
+            cout << " in pages of " << io_options.page_size << " bytes";
+        cout << endl;
+        if (io_options.alignment > 0)
+            cout << "Alignment: " << io_options.alignment << " bytes for objects of at least "
+                 << io_options.align_threshold << " bytes" << endl;
     }
 
-    vector<double> ou_process;
-    
-    size_t start, stop;
-    partition_work(path_count, myid, nprocs, start, stop);
-    size_t my_path_count = stop - start + 1;
+    // Time the phases of every rank; the barriers keep one phase's stragglers
+    // out of the next phase's times
+    MPI_Barrier(MPI_COMM_WORLD);
+    rank_timing timing(MPI_COMM_WORLD);
+    thread_pool workers(thread_count);
+
+    // This rank's paths; with fewer blocks than ranks, some ranks get none
+    vector<path_range> ranges;
+    switch (partition.scheme)
+    {
+    case partition_scheme::block:
+        ranges = {partition_block(path_count, myid, nprocs, partition.block)};
+        break;
+    case partition_scheme::block_cyclic:
+        ranges = partition_block_cyclic(path_count, myid, nprocs, partition.block);
+        break;
+    case partition_scheme::weighted:
+    {
+        // Weigh the ranks by how fast their threads sample a few paths
+        size_t probe_count = min(path_count, 64 * workers.size());
+        vector<double> probe(probe_count * step_count);
+        auto probe_start = MPI_Wtime();
+        ou_sampler(probe.data(), probe_count, step_count, dt, theta, mu, sigma, seed, stream, first_path, workers);
+        double speed = probe_count / max(MPI_Wtime() - probe_start, 1e-9);
+        vector<double> weights(nprocs);
+        MPI_Allgather(&speed, 1, MPI_DOUBLE, weights.data(), 1, MPI_DOUBLE, MPI_COMM_WORLD);
+        ranges = {partition_weighted(path_count, myid, weights, partition.block)};
+        break;
+    }
+    }
+    merge_ranges(ranges);
+    if (chunk[0] > 0)
+        report_contention(ranges, path_count, step_count, chunk, MPI_COMM_WORLD);
+    timing.stop("partition");
+
+    // The rows of all ranges, one after the other; path i is always path
+    // first_path + i of the stream, whichever rank and thread samples it
+    size_t my_path_count = accumulate(ranges.begin(), ranges.end(), size_t{0},
+                                      [](size_t sum, const path_range& r) { return sum + r.size(); });
+    vector<double> ou_process(my_path_count * step_count);
+    auto sample = [&]() {
+        size_t row = 0;
+        for (auto& range : ranges)
+        {
+            ou_sampler(ou_process.data() + row * step_count, range.size(), step_count, dt, theta, mu, sigma, seed, stream,
+                       first_path + range.first, workers);
+            row += range.size();
+        }
+        if (options.lossy == "bitround")
+        {
+            auto keepbits = bitround_keepbits(options.error_bound);
+            workers.parallel_for(ou_process.size(), 1 << 16, [&](size_t first, size_t last) {
+                bitround(ou_process.data() + first, last - first, keepbits);
+            });
+        }
+    };
 
-    ou_sampler(ou_process, my_path_count, step_count, dt, theta, mu, sigma);
+    if (io_options.sweep)
+    {
+        sample();
+        timing.stop("sample");
+        MPI_Barrier(MPI_COMM_WORLD);
+        sweep_drivers(options, io_options, path_count, step_count, ranges, ou_process);
+        MPI_Finalize();
+        return 0;
+    }
     
     // Use the Subfiling or MPI-IO driver
     hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+    auto info = make_mpi_info(io_options);
 #ifdef H5_HAVE_SUBFILING_VFD
     if(subfiling)
-      H5Pset_fapl_subfiling(fapl, NULL);
+      set_fapl_subfiling(fapl, io_options.stripe_sizes[0], io_options.iocs_per_node[0], io_options.ioc_threads[0]);
     else
 #endif
-      H5Pset_fapl_mpio(fapl, MPI_COMM_WORLD, MPI_INFO_NULL);
+      H5Pset_fapl_mpio(fapl, MPI_COMM_WORLD, info);
+    set_fapl_alignment(fapl, io_options);
+    set_fapl_metadata(fapl, io_options);
 
     //
     // Write the sample paths to an HDF5 file using the HDF5 C-API!
     //
-    auto file = H5Fcreate("ou_process.2.h5", H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
-
-    add_docstring(file, ".", "source", "https://github.com/HDFGroup/hdf5-tutorial");
-
-    { // create & write the dataset
-        hsize_t dimsf[] = {(hsize_t)path_count, (hsize_t)step_count};
-        auto filespace = H5Screate_simple(2, dimsf, NULL);
-        auto dataset = H5Dcreate(file, "/dataset", H5T_NATIVE_DOUBLE, filespace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
-        
-        // Define, by rank, a selection in memory and write it to a hyperslab in the file.
-        hsize_t count[]  = {my_path_count, step_count};
-        hsize_t offset[] = {start, 0};
-        
-        hid_t memspace = H5Screate_simple(2, count, NULL);
-
-        // Select hyperslab in the file.
-        // hid_t filespace = H5Dget_space(dataset);
-        H5Sselect_hyperslab(filespace, H5S_SELECT_SET, offset, NULL, count, NULL);
-
-        // <OPTIONAL> Create property list for collective dataset write.
-        hid_t dxpl = H5Pcreate(H5P_DATASET_XFER);
-        H5Pset_dxpl_mpio(dxpl, H5FD_MPIO_COLLECTIVE);
-
-        H5Dwrite(dataset, H5T_NATIVE_DOUBLE, memspace, filespace, dxpl, ou_process.data());
-
-        // housekeeping
-        H5Pclose(dxpl);
-        H5Sclose(memspace);
-        H5Dclose(dataset);
-        H5Pclose(fapl);
-        H5Sclose(filespace);
-    }
-
-    { // make the file self-describing by adding a few attributes to `dataset`
-        add_docstring(file, "dataset", "comment", "This dataset contains sample paths of an Ornstein-Uhlenbeck process.");
-        add_docstring(file, "dataset", "Wikipedia", "https://en.wikipedia.org/wiki/Ornstein%E2%80%93Uhlenbeck_process");
-        add_docstring(file, "dataset", "rows", "path");
-        add_docstring(file, "dataset", "columns", "time");
+    // Make the file self-describing; all ranks create the same attributes
+    // together, right after the dataset, instead of one by one at the end
+    attribute_batch attributes;
+    attributes.add(".", "source", string("https://github.com/HDFGroup/hdf5-tutorial"));
+    attributes.add("dataset", "comment", string("This dataset contains sample paths of an Ornstein-Uhlenbeck process."));
+    attributes.add("dataset", "Wikipedia", string("https://en.wikipedia.org/wiki/Ornstein%E2%80%93Uhlenbeck_process"));
+    attributes.add("dataset", "rows", string("path"));
+    attributes.add("dataset", "columns", string("time"));
+    add_rng_docstrings(attributes, "dataset", seed, stream, first_path);
+    add_lossy_attributes(attributes, "dataset", options);
+    attributes.add("dataset", "dt", dt);
+    attributes.add("dataset", "θ", theta);
+    attributes.add("dataset", "μ", mu);
+    attributes.add("dataset", "σ", sigma);
 
-        auto scalar = H5Screate(H5S_SCALAR);
-        auto acpl = H5Pcreate(H5P_ATTRIBUTE_CREATE);
-        H5Pset_char_encoding(acpl, H5T_CSET_UTF8);
-        
-        auto set_attribute = [&](const string& name, const double& value) {
-            auto attr = H5Acreate_by_name(file, "dataset", name.c_str(), H5T_NATIVE_DOUBLE, scalar, acpl, H5P_DEFAULT, H5P_DEFAULT);
-            H5Awrite(attr, H5T_NATIVE_DOUBLE, &value);
-            H5Aclose(attr);
-        };
-        set_attribute("dt", dt);
-        set_attribute("θ", theta);
-        set_attribute("μ", mu);
-        set_attribute("σ", sigma);
+    hid_t file, dataset;
+    auto create_file = [&]() {
+        auto fcpl = make_fcpl(io_options);
+        file = H5Fcreate("ou_process.2.h5", H5F_ACC_TRUNC, fcpl, fapl);
+        H5Pclose(fcpl);
+        if (info != MPI_INFO_NULL)
+            MPI_Info_free(&info);  // the file access property list keeps a copy
+        dataset = create_dataset(file, options, path_count, step_count);
+        attributes.write(file);
+    };
 
-        H5Pclose(acpl);
-        H5Sclose(scalar);
+    if (io_options.independent)
+    {
+        // Create the file first, so that every rank writes as soon as it has
+        // sampled, and only the closing of the file waits for the slowest
+        create_file();
+        timing.stop("create");
+        sample();
+        timing.stop("sample");
+        write_paths(dataset, ranges, step_count, ou_process, H5FD_MPIO_INDEPENDENT);
+        timing.stop("write");
+    }
+    else
+    {
+        sample();
+        timing.stop("sample");
+        MPI_Barrier(MPI_COMM_WORLD);
+        timing.stop("wait");
+        create_file();
+        MPI_Barrier(MPI_COMM_WORLD);
+        timing.stop("create");
+        write_paths(dataset, ranges, step_count, ou_process, H5FD_MPIO_COLLECTIVE);
+        timing.stop("write");
     }
 
+    // housekeeping
+    H5Dclose(dataset);
+    H5Pclose(fapl);
+
     H5Fclose(file);
+    timing.stop("close");
+
+    timing.report((double)ou_process.size() * sizeof(double), "write", io_options.per_rank_timing, io_options.histogram);
 
     MPI_Finalize();
 
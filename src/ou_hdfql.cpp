@@ -13,13 +13,16 @@ int main()
 {
     const size_t path_count = 100, step_count = 1000;
     const double dt = 0.01, theta = 1.0, mu = 0.0, sigma = 0.1;
+    const uint64_t seed = 0;
+    const uint32_t stream = 0;
 
     cout << "Running with parameters:"
          << " paths=" << path_count << " steps=" << step_count
-         << " dt=" << dt << " theta=" << theta << " mu=" << mu << " sigma=" << sigma << endl;
+         << " dt=" << dt << " theta=" << theta << " mu=" << mu << " sigma=" << sigma
+         << " seed=" << seed << " stream=" << stream << endl;
 
     vector<double> ou_process;
-    ou_sampler(ou_process, path_count, step_count, dt, theta, mu, sigma);
+    ou_sampler(ou_process, path_count, step_count, dt, theta, mu, sigma, seed, stream, 0, 0);
     
     //
     // Write the sample paths to an HDF5 file using the HDFql C++ bindings!
@@ -35,6 +38,10 @@ int main()
     HDFql::execute("CREATE ATTRIBUTE dataset/Wikipedia AS VARCHAR VALUES(\"https://en.wikipedia.org/wiki/Ornstein%E2%80%93Uhlenbeck_process\")");
     HDFql::execute("CREATE ATTRIBUTE dataset/rows AS VARCHAR VALUES(\"path\")");
     HDFql::execute("CREATE ATTRIBUTE dataset/columns AS VARCHAR VALUES(\"time\")");
+    HDFql::execute("CREATE ATTRIBUTE dataset/generator AS VARCHAR VALUES(\"Philox4x32-10 and Box-Muller, one stream per path\")");
+    HDFql::execute(sstr("CREATE ATTRIBUTE dataset/seed AS VARCHAR VALUES(\"" << seed << "\")"));
+    HDFql::execute(sstr("CREATE ATTRIBUTE dataset/stream AS VARCHAR VALUES(\"" << stream << "\")"));
+    HDFql::execute("CREATE ATTRIBUTE dataset/first_path AS VARCHAR VALUES(\"0\")");
     HDFql::execute(sstr("CREATE ATTRIBUTE dataset/dt AS DOUBLE VALUES(" << dt << ")"));
     HDFql::execute(sstr("CREATE ATTRIBUTE dataset/θ AS DOUBLE VALUES(" << theta << ")"));
     HDFql::execute(sstr("CREATE ATTRIBUTE dataset/μ AS DOUBLE VALUES(" << mu << ")"));
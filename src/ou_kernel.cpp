@@ -0,0 +1,80 @@
+#include "ou_kernel.hpp"
+#include "ou_kernel_impl.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+void ou_kernel_scalar
+(
+    double*  out,
+    size_t   path_count,
+    size_t   step_count,
+    uint64_t first_path,
+    double   dt,
+    double   theta,
+    double   mu,
+    double   sigma,
+    uint64_t seed,
+    uint32_t stream
+)
+{
+    ou_kernel_impl<scalar_isa>(out, path_count, step_count, first_path, dt, theta, mu, sigma, seed, stream);
+}
+
+namespace
+{
+    typedef void (*kernel_fn)(double*, size_t, size_t, uint64_t, double, double, double, double, uint64_t, uint32_t);
+
+    struct kernel_choice
+    {
+        kernel_fn   fn;
+        const char* isa;
+    };
+
+    // Picks the widest variant that was compiled in and that the CPU supports
+    kernel_choice choose_kernel()
+    {
+        auto wanted = getenv("OU_KERNEL");
+        auto allowed = [&](const char* isa) { return wanted == nullptr || strcmp(wanted, isa) == 0; };
+
+#if defined(OU_HAVE_AVX512)
+        if (allowed("avx512") && __builtin_cpu_supports("avx512f"))
+            return {ou_kernel_avx512, "avx512"};
+#endif
+#if defined(OU_HAVE_AVX2)
+        if (allowed("avx2") && __builtin_cpu_supports("avx2"))
+            return {ou_kernel_avx2, "avx2"};
+#endif
+        return {ou_kernel_scalar, "scalar"};
+    }
+
+    const kernel_choice& kernel()
+    {
+        static const kernel_choice choice = choose_kernel();
+        return choice;
+    }
+}
+
+void ou_kernel
+(
+    double*  out,
+    size_t   path_count,
+    size_t   step_count,
+    uint64_t first_path,
+    double   dt,
+    double   theta,
+    double   mu,
+    double   sigma,
+    uint64_t seed,
+    uint32_t stream
+)
+{
+    kernel().fn(out, path_count, step_count, first_path, dt, theta, mu, sigma, seed, stream);
+}
+
+const char* ou_kernel_isa()
+{
+    return kernel().isa;
+}
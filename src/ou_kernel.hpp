@@ -0,0 +1,36 @@
+#ifndef OU_KERNEL_HPP
+#define OU_KERNEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Fills `path_count` rows of length `step_count` in `out` (row-major) with the
+// sample paths `first_path`, `first_path + 1`, ... of the stream (`seed`, `stream`)
+//
+// Several paths are advanced together in SIMD lanes. The instruction set is
+// picked at runtime (AVX-512, AVX2, or scalar); it can be forced by setting the
+// environment variable OU_KERNEL to "avx512", "avx2", or "scalar". All variants
+// produce bit-for-bit the same paths.
+extern void ou_kernel
+(
+    double*  out,
+    size_t   path_count,
+    size_t   step_count,
+    uint64_t first_path,
+    double   dt,
+    double   theta,
+    double   mu,
+    double   sigma,
+    uint64_t seed,
+    uint32_t stream
+);
+
+// The name of the instruction set used by `ou_kernel`
+extern const char* ou_kernel_isa();
+
+// The individual variants; only call those the CPU supports
+extern void ou_kernel_scalar(double*, size_t, size_t, uint64_t, double, double, double, double, uint64_t, uint32_t);
+extern void ou_kernel_avx2(double*, size_t, size_t, uint64_t, double, double, double, double, uint64_t, uint32_t);
+extern void ou_kernel_avx512(double*, size_t, size_t, uint64_t, double, double, double, double, uint64_t, uint32_t);
+
+#endif
@@ -0,0 +1,48 @@
+// Compiled with -mavx2 (see CMakeLists.txt)
+
+#include "ou_kernel.hpp"
+#include "ou_kernel_impl.hpp"
+
+#include <immintrin.h>
+
+struct avx2_isa
+{
+    typedef __m256d vd;
+    static const size_t width = 4;
+
+    static vd   set1(double a) { return _mm256_set1_pd(a); }
+    static vd   load(const double* p) { return _mm256_load_pd(p); }
+    static void store(double* p, vd a) { _mm256_store_pd(p, a); }
+    static vd   sqrt(vd a) { return _mm256_sqrt_pd(a); }
+    static vd   floor(vd a) { return _mm256_floor_pd(a); }
+    static vd   select_gt(vd a, vd b, vd t, vd f) { return _mm256_blendv_pd(f, t, _mm256_cmp_pd(a, b, _CMP_GT_OQ)); }
+    static vd   select_eq(vd a, vd b, vd t, vd f) { return _mm256_blendv_pd(f, t, _mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+
+    static void split(vd a, vd& m, vd& e)
+    {
+        auto bits = _mm256_castpd_si256(a);
+        // 2^52 + biased exponent, as a double, minus 2^52
+        auto biased = _mm256_or_si256(_mm256_srli_epi64(bits, 52), _mm256_set1_epi64x(0x4330000000000000ll));
+        e = _mm256_castsi256_pd(biased) - _mm256_set1_pd(4503599627370496.0 + 1023.0);
+        bits = _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFll)),
+                               _mm256_set1_epi64x(0x3FF0000000000000ll));
+        m = _mm256_castsi256_pd(bits);
+    }
+};
+
+void ou_kernel_avx2
+(
+    double*  out,
+    size_t   path_count,
+    size_t   step_count,
+    uint64_t first_path,
+    double   dt,
+    double   theta,
+    double   mu,
+    double   sigma,
+    uint64_t seed,
+    uint32_t stream
+)
+{
+    ou_kernel_impl<avx2_isa>(out, path_count, step_count, first_path, dt, theta, mu, sigma, seed, stream);
+}
@@ -0,0 +1,48 @@
+// Compiled with -mavx512f (see CMakeLists.txt)
+
+#include "ou_kernel.hpp"
+#include "ou_kernel_impl.hpp"
+
+#include <immintrin.h>
+
+struct avx512_isa
+{
+    typedef __m512d vd;
+    static const size_t width = 8;
+
+    static vd   set1(double a) { return _mm512_set1_pd(a); }
+    static vd   load(const double* p) { return _mm512_load_pd(p); }
+    static void store(double* p, vd a) { _mm512_store_pd(p, a); }
+    static vd   sqrt(vd a) { return _mm512_sqrt_pd(a); }
+    static vd   floor(vd a) { return _mm512_floor_pd(a); }
+    static vd   select_gt(vd a, vd b, vd t, vd f) { return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(a, b, _CMP_GT_OQ), f, t); }
+    static vd   select_eq(vd a, vd b, vd t, vd f) { return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ), f, t); }
+
+    static void split(vd a, vd& m, vd& e)
+    {
+        auto bits = _mm512_castpd_si512(a);
+        // 2^52 + biased exponent, as a double, minus 2^52
+        auto biased = _mm512_or_si512(_mm512_srli_epi64(bits, 52), _mm512_set1_epi64(0x4330000000000000ll));
+        e = _mm512_castsi512_pd(biased) - _mm512_set1_pd(4503599627370496.0 + 1023.0);
+        bits = _mm512_or_si512(_mm512_and_si512(bits, _mm512_set1_epi64(0x000FFFFFFFFFFFFFll)),
+                               _mm512_set1_epi64(0x3FF0000000000000ll));
+        m = _mm512_castsi512_pd(bits);
+    }
+};
+
+void ou_kernel_avx512
+(
+    double*  out,
+    size_t   path_count,
+    size_t   step_count,
+    uint64_t first_path,
+    double   dt,
+    double   theta,
+    double   mu,
+    double   sigma,
+    uint64_t seed,
+    uint32_t stream
+)
+{
+    ou_kernel_impl<avx512_isa>(out, path_count, step_count, first_path, dt, theta, mu, sigma, seed, stream);
+}
@@ -0,0 +1,107 @@
+#ifndef OU_KERNEL_IMPL_HPP
+#define OU_KERNEL_IMPL_HPP
+
+#include "ou_math.hpp"
+#include "philox.hpp"
+
+#include <algorithm>
+
+// Advances `V::width` paths, one per SIMD lane, starting with path `first_path`
+// whose row begins at `out`
+//
+// Work proceeds in tiles of `TILE` steps: draw the uniforms for all lanes from
+// their Philox streams, run Box-Muller on whole vectors, run the recurrence on
+// whole vectors, and finally copy the tile's columns into the output rows.
+template <class V>
+void ou_lanes
+(
+    double*  out,
+    size_t   step_count,
+    uint64_t first_path,
+    double   dt,
+    double   theta,
+    double   mu,
+    double   sigma,
+    uint64_t seed,
+    uint32_t stream
+)
+{
+    const size_t W = V::width, TILE = 128;
+
+    alignas(64) double u1[TILE / 2 * W], u2[TILE / 2 * W], z[TILE * W];
+
+    const philox_key key = {(uint32_t)seed, (uint32_t)(seed >> 32)};
+    const auto dt_v = V::set1(dt), theta_v = V::set1(theta), mu_v = V::set1(mu), sigma_v = V::set1(sigma);
+    const auto sqrt_dt_v = V::set1(std::sqrt(dt));
+
+    auto x = V::set1(0.0);  // sample paths start at x = 0
+    for (size_t l = 0; l < W; ++l)
+        out[l * step_count] = 0;
+
+    for (size_t j0 = 1; j0 < step_count; j0 += TILE)
+    {
+        auto n = std::min(TILE, step_count - j0), pairs = (n + 1) / 2;
+
+        // Uniforms: step j uses variate j - 1, two variates per Philox call
+        for (size_t p = 0; p < pairs; ++p)
+            for (size_t l = 0; l < W; ++l)
+            {
+                uint64_t path = first_path + l;
+                auto r = philox4x32({(uint32_t)((j0 - 1) / 2 + p), (uint32_t)path, (uint32_t)(path >> 32), stream}, key);
+                u1[p * W + l] = 1.0 - philox_uniform(r[0], r[1]);
+                u2[p * W + l] = philox_uniform(r[2], r[3]);
+            }
+
+        // Gaussian increments, even variates from the cosine, odd ones from the sine
+        for (size_t p = 0; p < pairs; ++p)
+        {
+            typename V::vd z0, z1;
+            box_muller<V>(V::load(&u1[p * W]), V::load(&u2[p * W]), z0, z1);
+            V::store(&z[2 * p * W], z0);
+            V::store(&z[(2 * p + 1) * W], z1);
+        }
+
+        // The recurrence, in place of the increments
+        for (size_t k = 0; k < n; ++k)
+        {
+            auto dW = sqrt_dt_v * V::load(&z[k * W]);
+            x = x + theta_v * (mu_v - x) * dt_v + sigma_v * dW;
+            V::store(&z[k * W], x);
+        }
+
+        for (size_t l = 0; l < W; ++l)
+        {
+            auto row = out + l * step_count + j0;
+            for (size_t k = 0; k < n; ++k)
+                row[k] = z[k * W + l];
+        }
+    }
+}
+
+// Advances `path_count` paths, `V::width` at a time, and the rest one at a time
+template <class V>
+void ou_kernel_impl
+(
+    double*  out,
+    size_t   path_count,
+    size_t   step_count,
+    uint64_t first_path,
+    double   dt,
+    double   theta,
+    double   mu,
+    double   sigma,
+    uint64_t seed,
+    uint32_t stream
+)
+{
+    if (step_count == 0)
+        return;
+
+    size_t i = 0;
+    for (; i + V::width <= path_count; i += V::width)
+        ou_lanes<V>(out + i * step_count, step_count, first_path + i, dt, theta, mu, sigma, seed, stream);
+    for (; i < path_count; ++i)
+        ou_lanes<scalar_isa>(out + i * step_count, step_count, first_path + i, dt, theta, mu, sigma, seed, stream);
+}
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef OU_MATH_HPP
+#define OU_MATH_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Box-Muller transform written once for scalars and SIMD vectors
+//
+// The functions below are templates over an "ISA" type `V` that provides the
+// vector type `V::vd` (with +, -, *, / and unary -) and a handful of helpers.
+// They only use correctly rounded IEEE operations (no FMA, no libm), so every
+// instantiation returns bit-for-bit the same variates for the same uniforms.
+
+// Scalar instantiation, which also serves as the reference
+struct scalar_isa
+{
+    typedef double vd;
+    static const size_t width = 1;
+
+    static vd   set1(double a) { return a; }
+    static vd   load(const double* p) { return *p; }
+    static void store(double* p, vd a) { *p = a; }
+    static vd   sqrt(vd a) { return std::sqrt(a); }
+    static vd   floor(vd a) { return std::floor(a); }
+    static vd   select_gt(vd a, vd b, vd t, vd f) { return (a > b) ? t : f; }
+    static vd   select_eq(vd a, vd b, vd t, vd f) { return (a == b) ? t : f; }
+
+    // Splits a positive normal `a` into `m` in [1, 2) and the exponent `e`
+    static void split(vd a, vd& m, vd& e)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &a, sizeof(bits));
+        e = (double)(int)(bits >> 52) - 1023.0;
+        bits = (bits & 0x000FFFFFFFFFFFFFull) | 0x3FF0000000000000ull;
+        std::memcpy(&m, &bits, sizeof(bits));
+    }
+};
+
+// Natural logarithm of `u` in (0, 1]
+template <class V>
+inline typename V::vd ou_log(typename V::vd u)
+{
+    typedef typename V::vd vd;
+
+    vd m, e;
+    V::split(u, m, e);
+
+    // Center the mantissa on 1 so that |s| <= 0.1716 below
+    auto big = V::set1(1.4142135623730951);
+    e = V::select_gt(m, big, e + V::set1(1.0), e);
+    m = V::select_gt(m, big, m * V::set1(0.5), m);
+
+    // log(m) = 2 atanh(s) = 2 (s + s^3/3 + s^5/5 + ...), s = (m - 1) / (m + 1)
+    auto s = (m - V::set1(1.0)) / (m + V::set1(1.0));
+    auto s2 = s * s;
+    auto p = V::set1(1.0 / 23);
+    for (int k = 21; k >= 3; k -= 2)
+        p = p * s2 + V::set1(1.0 / k);
+    p = p * s2;
+
+    const double ln2_hi = 6.93147180369123816490e-01, ln2_lo = 1.90821492927058770002e-10;
+    auto two_s = s + s;
+    return e * V::set1(ln2_hi) + (two_s + (two_s * p + e * V::set1(ln2_lo)));
+}
+
+// Cosine and sine of 2 pi `u` for `u` in [0, 1)
+template <class V>
+inline void ou_sincos_2pi(typename V::vd u, typename V::vd& c, typename V::vd& s)
+{
+    // Reduce to x in [-pi/4, pi/4] and the quadrant q in {0, 1, 2, 3}
+    auto t = u * V::set1(4.0);
+    auto q = V::floor(t + V::set1(0.5));
+    auto x = (t - q) * V::set1(1.5707963267948966);
+    q = q - V::set1(4.0) * V::floor(q * V::set1(0.25));
+
+    // Taylor polynomials, accurate to about one ulp on [-pi/4, pi/4]
+    auto x2 = x * x;
+    auto sp = V::set1(1.0 / 355687428096000.0);  // 1/17!
+    sp = sp * x2 - V::set1(1.0 / 1307674368000.0);
+    sp = sp * x2 + V::set1(1.0 / 6227020800.0);
+    sp = sp * x2 - V::set1(1.0 / 39916800.0);
+    sp = sp * x2 + V::set1(1.0 / 362880.0);
+    sp = sp * x2 - V::set1(1.0 / 5040.0);
+    sp = sp * x2 + V::set1(1.0 / 120.0);
+    sp = sp * x2 - V::set1(1.0 / 6.0);
+    auto sx = x + x * x2 * sp;
+
+    auto cp = V::set1(1.0 / 6402373705728000.0);  // 1/18!
+    cp = cp * x2 - V::set1(1.0 / 20922789888000.0);
+    cp = cp * x2 + V::set1(1.0 / 87178291200.0);
+    cp = cp * x2 - V::set1(1.0 / 479001600.0);
+    cp = cp * x2 + V::set1(1.0 / 3628800.0);
+    cp = cp * x2 - V::set1(1.0 / 40320.0);
+    cp = cp * x2 + V::set1(1.0 / 720.0);
+    cp = cp * x2 - V::set1(1.0 / 24.0);
+    cp = cp * x2 + V::set1(0.5);
+    auto cx = V::set1(1.0) - x2 * cp;
+
+    // Rotate by q quarter turns
+    c = V::select_eq(q, V::set1(1.0), -sx,
+        V::select_eq(q, V::set1(2.0), -cx,
+        V::select_eq(q, V::set1(3.0), sx, cx)));
+    s = V::select_eq(q, V::set1(1.0), cx,
+        V::select_eq(q, V::set1(2.0), -sx,
+        V::select_eq(q, V::set1(3.0), -cx, sx)));
+}
+
+// Turns uniforms `u1` in (0, 1] and `u2` in [0, 1) into two N(0, 1) variates
+template <class V>
+inline void box_muller(typename V::vd u1, typename V::vd u2, typename V::vd& z0, typename V::vd& z1)
+{
+    typename V::vd c, s;
+    auto radius = V::sqrt(V::set1(-2.0) * ou_log<V>(u1));
+    ou_sincos_2pi<V>(u2, c, s);
+    z0 = radius * c;
+    z1 = radius * s;
+}
+
+#endif
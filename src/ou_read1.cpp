@@ -0,0 +1,131 @@
+#include "docstring.hpp"
+#include "ou_kernel.hpp"
+#include "ou_sampler1.hpp"
+#include "path_reader.hpp"
+
+#include "argparse.hpp"
+#include "hdf5.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Fetches random sample paths from an `ou_hdf5.1` file through a `path_reader`,
+// reports the rate, and (optionally) checks every path against its regeneration
+int main(int argc, char *argv[])
+{
+    argparse::ArgumentParser program("ou_read1");
+    program.add_argument("file")
+    .help("chooses the file to read")
+    .default_value(string{"ou_process.1.h5"});
+    program.add_argument("-n", "--count")
+    .help("chooses the number of random paths to fetch")
+    .default_value(size_t{100000})
+    .scan<'u', size_t>();
+    program.add_argument("-b", "--batch")
+    .help("chooses the number of paths requested at a time")
+    .default_value(size_t{1024})
+    .scan<'u', size_t>();
+    program.add_argument("--cache")
+    .help("chooses the size of the block cache in MiB")
+    .default_value(size_t{256})
+    .scan<'u', size_t>();
+    program.add_argument("--verify")
+    .help("regenerates every fetched path and compares it with the stored one")
+    .default_value(false)
+    .implicit_value(true);
+    program.parse_args(argc, argv);
+
+    auto name = program.get<string>("file");
+    auto count = program.get<size_t>("--count");
+    auto batch_size = max<size_t>(1, program.get<size_t>("--batch"));
+    auto verify = program.get<bool>("--verify");
+
+    auto file = H5Fopen(name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (file < 0) {
+        cerr << "Cannot open " << name << endl;
+        return 1;
+    }
+
+    // the reader closes its datasets before the file is closed, whatever the outcome
+    auto status = [&] {
+        path_reader reader(file, program.get<size_t>("--cache") << 20);
+        if (reader.size() == 0) {
+            cerr << name << " holds no paths" << endl;
+            return 1;
+        }
+
+        auto get_attribute = [&](const string& key) {
+            double value = 0.0;
+            if (H5Aexists_by_name(file, "paths", key.c_str(), H5P_DEFAULT) > 0)
+            {
+                auto attr = H5Aopen_by_name(file, "paths", key.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+                H5Aread(attr, H5T_NATIVE_DOUBLE, &value);
+                H5Aclose(attr);
+            }
+            return value;
+        };
+        double dt = get_attribute("dt"), theta = get_attribute("θ"), mu = get_attribute("μ"), sigma = get_attribute("σ");
+        auto seed_str = get_docstring(file, "paths", "seed");
+        if (verify && seed_str.empty()) {
+            cerr << name << " does not record the seed of its paths" << endl;
+            return 1;
+        }
+        auto stream_str = get_docstring(file, "paths", "stream"), first_path_str = get_docstring(file, "paths", "first_path");
+        if (verify && (stream_str.empty() || first_path_str.empty())) {
+            cerr << name << " does not record the " << (stream_str.empty() ? "stream" : "first_path") << " of its paths" << endl;
+            return 1;
+        }
+        uint64_t seed = verify ? stoull(seed_str) : 0;
+        uint32_t stream = verify ? (uint32_t)stoul(stream_str) : 0;
+        size_t first_path = verify ? stoull(first_path_str) : 0;
+
+        cout << "Fetching " << count << " random paths of " << reader.size() << " in batches of " << batch_size << endl;
+
+        mt19937_64 pick(1);
+        uniform_int_distribution<size_t> any_path(0, reader.size() - 1);
+        vector<size_t> wanted;
+        vector<double> expected;
+        size_t fetched_values = 0, mismatches = 0;
+        chrono::duration<double> reading{0};
+
+        for (size_t done = 0; done < count; done += wanted.size())
+        {
+            wanted.resize(min(batch_size, count - done));
+            for (auto& i : wanted)
+                i = any_path(pick);
+
+            auto t = chrono::steady_clock::now();
+            auto paths = reader.get_paths(wanted);
+            reading += chrono::steady_clock::now() - t;
+
+            for (size_t k = 0; k < paths.size(); ++k)
+            {
+                fetched_values += paths[k].size;
+                if (!verify)
+                    continue;
+                auto path = first_path + wanted[k];
+                expected.resize(ou_path_length(seed, stream, path));
+                ou_kernel(expected.data(), 1, expected.size(), path, dt, theta, mu, sigma, seed, stream);
+                if (paths[k].size != expected.size() || !equal(paths[k].begin(), paths[k].end(), expected.begin()))
+                    ++mismatches;
+            }
+        }
+
+        double mib = (double)fetched_values * sizeof(double) / (1 << 20);
+        cout << "Fetched " << mib << " MiB in " << reading.count() << " s (" << count / reading.count() << " paths/s, "
+             << mib / reading.count() << " MiB/s) with " << reader.read_count() << " hyperslab reads of "
+             << (double)reader.read_values() * sizeof(double) / (1 << 20) << " MiB" << endl;
+        if (verify)
+            cout << mismatches << " mismatches" << (mismatches == 0 ? " PASSED" : " FAILED") << endl;
+        return mismatches > 0 ? 1 : 0;
+    }();
+
+    H5Fclose(file);
+
+    return status;
+}
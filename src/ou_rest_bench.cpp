@@ -0,0 +1,215 @@
+#include "hsds_client.hpp"
+#include "hsds_domain.hpp"
+#include "hsds_standin.hpp"
+#include "ou_sampler.hpp"
+#include "read_planner.hpp"
+
+#include "argparse.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// What `client` did since it had the stats `before`
+static rest_stats stats_since(const hsds_client& client, const rest_stats& before)
+{
+    auto& now = client.stats();
+    rest_stats delta;
+    delta.requests = now.requests - before.requests;
+    delta.bytes_sent = now.bytes_sent - before.bytes_sent;
+    delta.bytes_received = now.bytes_received - before.bytes_received;
+    delta.latencies.assign(now.latencies.begin() + before.latencies.size(), now.latencies.end());
+    return delta;
+}
+
+// One line of the results table
+static void print_result(const char* op, const rest_stats& stats, const double& seconds)
+{
+    auto bytes = (double)(stats.bytes_sent + stats.bytes_received);
+    printf("%-8s %9zu %10.1f %10.4f %10.1f %9.2f %9.2f %9.2f\n", op, stats.requests, bytes / (1 << 20), seconds,
+           bytes / seconds / (1 << 20), 1000 * percentile(stats.latencies, 0.5), 1000 * percentile(stats.latencies, 0.9),
+           1000 * percentile(stats.latencies, 0.99));
+}
+
+// Measures writing and reading sample paths through the HSDS REST API
+//
+// By default the requests go to an in-process stand-in for HSDS on 127.0.0.1,
+// which can add a per-request latency, a per-connection bandwidth limit, and a
+// bandwidth limit for all connections together, so that request counts and
+// sizes can be tuned without a server or a network. The stand-in does not
+// chunk its datasets, so --chunk only aligns the planned requests. With --endpoint, the same requests go to a real HSDS instead.
+//
+// The paths are written and read back in blocks of --block rows, one request
+// per block, and then read again with a `read_planner`, which merges the
+// blocks into chunk-aligned requests of up to --request_size on
+// --connections concurrent connections.
+int main(int argc, char *argv[])
+{
+    argparse::ArgumentParser program("ou_rest_bench");
+    program.add_argument("-p", "--paths")
+    .help("chooses the number of sample paths")
+    .default_value(size_t{1000})
+    .scan<'u', size_t>();
+    program.add_argument("-s", "--steps")
+    .help("chooses the number of time steps")
+    .default_value(size_t{1000})
+    .scan<'u', size_t>();
+    program.add_argument("--block")
+    .help("chooses the rows per request (0 = about 4 MiB per request)")
+    .default_value(size_t{0})
+    .scan<'u', size_t>();
+    program.add_argument("--chunk")
+    .help("chooses the rows per chunk of the dataset (0 = the server chooses)")
+    .default_value(size_t{0})
+    .scan<'u', size_t>();
+    program.add_argument("--connections")
+    .help("chooses the number of concurrent connections of the planned read")
+    .default_value(size_t{4})
+    .scan<'u', size_t>();
+    program.add_argument("--request_size")
+    .help("chooses the most bytes one request of the planned read fetches")
+    .default_value(size_t{4 << 20})
+    .scan<'u', size_t>();
+    program.add_argument("--merge_gap")
+    .help("merges selections up to this many rows apart in the planned read")
+    .default_value(size_t{0})
+    .scan<'u', size_t>();
+    program.add_argument("--latency")
+    .help("adds this many milliseconds to every request to the stand-in")
+    .default_value(0.0)
+    .scan<'g', double>();
+    program.add_argument("--bandwidth")
+    .help("limits every connection to the stand-in to this many MiB/s (0 = unlimited)")
+    .default_value(0.0)
+    .scan<'g', double>();
+    program.add_argument("--link_bandwidth")
+    .help("limits all connections to the stand-in together to this many MiB/s (0 = unlimited)")
+    .default_value(0.0)
+    .scan<'g', double>();
+    program.add_argument("--endpoint")
+    .help("sends the requests to this HSDS (e.g., http://localhost:5101) instead of the stand-in");
+    program.add_argument("--domain")
+    .help("chooses the domain written (default: ou_rest_bench.h5 in the folder of hsds_domain)");
+    program.parse_args(argc, argv);
+
+    auto path_count = program.get<size_t>("--paths");
+    auto step_count = program.get<size_t>("--steps");
+    auto block = program.get<size_t>("--block");
+    read_plan_options plan;
+    plan.chunk_rows = program.get<size_t>("--chunk");
+    plan.connections = program.get<size_t>("--connections");
+    plan.max_request_bytes = program.get<size_t>("--request_size");
+    plan.merge_gap = program.get<size_t>("--merge_gap");
+    auto latency = program.get<double>("--latency");
+    auto bandwidth = program.get<double>("--bandwidth");
+    auto link_bandwidth = program.get<double>("--link_bandwidth");
+    if (path_count == 0 || step_count == 0 || latency < 0 || bandwidth < 0 || link_bandwidth < 0)
+    {
+        cerr << "The path and step counts must be positive, the latency and bandwidths non-negative." << endl;
+        return -1;
+    }
+    if (plan.connections == 0)
+    {
+        cerr << "The planned read needs at least one connection." << endl;
+        return -1;
+    }
+    if (block == 0)
+        block = max<size_t>(1, (4 << 20) / (step_count * sizeof(double)));
+    block = min(block, path_count);
+    auto domain = program.present("--domain") ? program.get<string>("--domain") : hsds_domain("ou_rest_bench.h5");
+
+    unique_ptr<hsds_standin> standin;
+    string endpoint;
+    if (auto e = program.present("--endpoint"))
+        endpoint = *e;
+    else
+    {
+        standin = make_unique<hsds_standin>(latency / 1000, bandwidth * (1 << 20), link_bandwidth * (1 << 20));
+        endpoint = standin->endpoint();
+    }
+
+    vector<double> ou_process;
+    ou_sampler(ou_process, path_count, step_count, 0.01, 1.0, 0.0, 0.1, 0, 0, 0, 0);
+
+    try
+    {
+        using clock = chrono::steady_clock;
+        hsds_client client(endpoint);
+        auto root = client.create_domain(domain);
+        auto id = client.create_dataset(domain, root, "dataset", path_count, step_count, plan.chunk_rows);
+
+        auto before = client.stats();
+        auto t = clock::now();
+        for (size_t first = 0; first < path_count; first += block)
+        {
+            auto last = min(first + block, path_count);
+            client.write_rows(domain, id, first, last, step_count, &ou_process[first * step_count]);
+        }
+        auto write_seconds = chrono::duration<double>(clock::now() - t).count();
+        auto write_stats = stats_since(client, before);
+
+        vector<double> back(ou_process.size());
+        before = client.stats();
+        t = clock::now();
+        for (size_t first = 0; first < path_count; first += block)
+        {
+            auto last = min(first + block, path_count);
+            client.read_rows(domain, id, first, last, step_count, &back[first * step_count]);
+        }
+        auto read_seconds = chrono::duration<double>(clock::now() - t).count();
+        auto read_stats = stats_since(client, before);
+
+        // the same blocks again, planned
+        vector<double> planned(ou_process.size());
+        vector<row_selection> selections;
+        for (size_t first = 0; first < path_count; first += block)
+            selections.push_back({first, min(first + block, path_count), &planned[first * step_count]});
+        read_planner planner(endpoint, plan);
+        t = clock::now();
+        auto planned_stats = planner.read(domain, id, step_count, selections);
+        auto planned_seconds = chrono::duration<double>(clock::now() - t).count();
+
+        cout << "Endpoint: " << endpoint << (standin ? " (stand-in)" : "") << ", domain " << domain << endl;
+        if (standin)
+        {
+            auto limit = [](double mib_s) {
+                ostringstream text;
+                if (mib_s > 0)
+                    text << mib_s << " MiB/s";
+                else
+                    text << "unlimited";
+                return text.str();
+            };
+            cout << "Latency: " << latency << " ms, bandwidth: " << limit(bandwidth) << " per connection, "
+                 << limit(link_bandwidth) << " in all" << endl;
+            cout << "Chunks: not modeled by the stand-in (--chunk only aligns the planned requests)" << endl;
+        }
+        cout << "Blocks: " << selections.size() << " of " << block << " rows, planned read: "
+             << plan_reads(selections, step_count, plan).size() << " requests on " << plan.connections
+             << " connections" << endl;
+        printf("%-8s %9s %10s %10s %10s %9s %9s %9s\n", "op", "requests", "MiB", "seconds", "MiB/s",
+               "p50 ms", "p90 ms", "p99 ms");
+        print_result("write", write_stats, write_seconds);
+        print_result("read", read_stats, read_seconds);
+        print_result("planned", planned_stats, planned_seconds);
+
+        if (back != ou_process || planned != ou_process)
+        {
+            cerr << "The paths read back differ from the paths written." << endl;
+            return -1;
+        }
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << endl;
+        return -1;
+    }
+
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "docstring.hpp"
+#include "hsds_domain.hpp"
 #include "ou_sampler.hpp"
 #include "rest_vol_public.h"
 #include "hdf5.h"
@@ -11,13 +12,16 @@ int main()
 {
     const size_t path_count = 100, step_count = 1000;
     const double dt = 0.01, theta = 1.0, mu = 0.0, sigma = 0.1;
+    const uint64_t seed = 0;
+    const uint32_t stream = 0;
 
     cout << "Running with parameters:"
          << " paths=" << path_count << " steps=" << step_count
-         << " dt=" << dt << " theta=" << theta << " mu=" << mu << " sigma=" << sigma << endl;
+         << " dt=" << dt << " theta=" << theta << " mu=" << mu << " sigma=" << sigma
+         << " seed=" << seed << " stream=" << stream << endl;
 
     vector<double> ou_process;
-    ou_sampler(ou_process, path_count, step_count, dt, theta, mu, sigma);
+    ou_sampler(ou_process, path_count, step_count, dt, theta, mu, sigma, seed, stream, 0, 0);
     
     //
     // Write the sample paths to an HDF5 file using the HDF5 REST VOL!
@@ -26,7 +30,7 @@ int main()
     H5rest_init();
     auto fapl = H5Pcreate(H5P_FILE_ACCESS);
     H5Pset_fapl_rest_vol(fapl);
-    auto file = H5Fcreate("/home/vscode/ou_restvol.h5", H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+    auto file = H5Fcreate(hsds_domain("ou_restvol.h5").c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
     H5Pclose(fapl);
 
     add_docstring(file, ".", "source", "https://github.com/HDFGroup/hdf5-tutorial");
@@ -45,6 +49,7 @@ int main()
         add_docstring(file, "dataset", "Wikipedia", "https://en.wikipedia.org/wiki/Ornstein%E2%80%93Uhlenbeck_process");
         add_docstring(file, "dataset", "rows", "path");
         add_docstring(file, "dataset", "columns", "time");
+        add_rng_docstrings(file, "dataset", seed, stream, 0);
         
         auto scalar = H5Screate(H5S_SCALAR);
         auto acpl = H5Pcreate(H5P_ATTRIBUTE_CREATE);
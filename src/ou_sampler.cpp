@@ -1,5 +1,6 @@
-
-#include <random>
+#include "ou_sampler.hpp"
+#include "ou_kernel.hpp"
+#include "thread_pool.hpp"
 
 using namespace std;
 
@@ -11,25 +12,39 @@ void ou_sampler
     const double&   dt,
     const double&   theta,
     const double&   mu,
-    const double&   sigma
+    const double&   sigma,
+    const uint64_t& seed,
+    const uint32_t& stream,
+    const size_t&   first_path,
+    const size_t&   thread_count
 )
 {
     // Store sample paths in one contiguous buffer
     ou_process.clear();
     ou_process.resize(path_count * step_count);
 
-    random_device rd;
-    mt19937 generator(rd());
-    normal_distribution<double> dist(0.0, sqrt(dt));
+    thread_pool pool(thread_count);
+    ou_sampler(ou_process.data(), path_count, step_count, dt, theta, mu, sigma, seed, stream, first_path, pool);
+}
 
-    for (size_t i = 0; i < path_count; ++i)
-    {
-        ou_process[i * step_count] = 0; // sample paths start at x = 0
-        for (size_t j = 1; j < step_count; ++j)
-        {
-            auto dW = dist(generator);
-            auto pos = i * step_count + j;
-            ou_process[pos] = ou_process[pos - 1] + theta * (mu - ou_process[pos - 1]) * dt + sigma * dW;
-        }
-    }
+void ou_sampler
+(
+    double*         ou_process,
+    const size_t&   path_count,
+    const size_t&   step_count,
+    const double&   dt,
+    const double&   theta,
+    const double&   mu,
+    const double&   sigma,
+    const uint64_t& seed,
+    const uint32_t& stream,
+    const size_t&   first_path,
+    thread_pool&    pool
+)
+{
+    // Blocks of paths are a multiple of the widest SIMD width
+    pool.parallel_for(path_count, 64, [&](size_t first, size_t last) {
+        ou_kernel(ou_process + first * step_count, last - first, step_count, first_path + first,
+                  dt, theta, mu, sigma, seed, stream);
+    });
 }
@@ -1,10 +1,19 @@
 #ifndef OU_SAMPLER_HPP
 #define OU_SAMPLER_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
+class thread_pool;
+
 // Creates `path_count` sample paths of length `step_count` with parameters
 // `dt`, `theta`, `mu`, and `sigma`
+//
+// Path i is path `first_path + i` of the random stream (`seed`, `stream`), so
+// the same arguments always give the same paths, and any range of paths can be
+// regenerated on its own. The paths are generated on `thread_count` threads
+// (0 = one per hardware thread); the result does not depend on that number.
 extern void ou_sampler
 (
     std::vector<double>& ou_process,
@@ -13,7 +22,29 @@ extern void ou_sampler
     const double&        dt,
     const double&        theta,
     const double&        mu,
-    const double&        sigma
+    const double&        sigma,
+    const uint64_t&      seed,
+    const uint32_t&      stream,
+    const size_t&        first_path,
+    const size_t&        thread_count
+);
+
+// Same as above, but writes the paths to `ou_process` (room for `path_count`
+// x `step_count` doubles) on the threads of `pool`, so that callers sampling
+// many ranges start the threads once
+extern void ou_sampler
+(
+    double*              ou_process,
+    const size_t&        path_count,
+    const size_t&        step_count,
+    const double&        dt,
+    const double&        theta,
+    const double&        mu,
+    const double&        sigma,
+    const uint64_t&      seed,
+    const uint32_t&      stream,
+    const size_t&        first_path,
+    thread_pool&         pool
 );
 
 #endif
@@ -1,9 +1,20 @@
 
 #include "ou_sampler1.hpp"
-#include <random>
+#include "ou_kernel.hpp"
+#include "philox.hpp"
+
+#include <climits>
 
 using namespace std;
 
+size_t ou_path_length(const uint64_t& seed, const uint32_t& stream, const size_t& path)
+{
+    // The steps of a path use the low counter values, the length uses the highest
+    auto r = philox4x32({UINT32_MAX, (uint32_t)path, (uint32_t)((uint64_t)path >> 32), stream},
+                        {(uint32_t)seed, (uint32_t)(seed >> 32)});
+    return 1 + (size_t)(((uint64_t)r[0] * USHRT_MAX) >> 32);  // path length is between 1 and 65535
+}
+
 void ou_sampler1
 (
     vector<double>&  ou_process,
@@ -12,39 +23,26 @@ void ou_sampler1
     const double&    dt,
     const double&    theta,
     const double&    mu,
-    const double&    sigma
+    const double&    sigma,
+    const uint64_t&  seed,
+    const uint32_t&  stream,
+    const size_t&    first_path,
+    thread_pool&     pool
 )
 {
-    // Store sample paths in one contiguous buffer
-    ou_process.clear();
-    offset.clear();
-    offset.push_back(0);
-
-    random_device rd;
-    mt19937 generator(rd());
-    uniform_int_distribution<unsigned int> path_len_dist(1, USHRT_MAX);  // path length is between 1 and 65535
-    normal_distribution<double> dist(0.0, sqrt(dt));  // N(0, dt)
-
-    size_t pos = 0;  // offset into the ou_process vector
-
-    // Generate a batch of paths and offsets
+    // Phase 1: draw the path lengths and turn them into offsets (prefix sum)
+    offset.resize(batch_size + 1);
+    offset[0] = 0;
     for (size_t i = 0; i < batch_size; ++i)
-    {
-        // Generate random path length
-        size_t step_count = path_len_dist(generator);
-        // Resize the vector to make room for the new path
-        ou_process.resize(pos + step_count);  
-            
-        // Generate the path
-        ou_process[pos] = 0; // start at x = 0
-        for (size_t j = 1; j < step_count; ++j)
-        {
-            auto dW = dist(generator);
-            ++pos;  // advance the offset
-            ou_process[pos] = ou_process[pos - 1] + theta * (mu - ou_process[pos - 1]) * dt + sigma * dW;
-        }
+        offset[i + 1] = offset[i] + (hsize_t)ou_path_length(seed, stream, first_path + i);
+
+    // Store sample paths in one contiguous buffer, allocated (at most) once per batch
+    ou_process.resize(offset.back());
 
-        // This is the offset of the next path
-        offset.push_back(offset.back() + (hsize_t)step_count);  
-    }
+    // Phase 2: every path knows its place, so the paths can be generated in any order
+    pool.parallel_for(batch_size, 4, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i)
+            ou_kernel(&ou_process[offset[i]], 1, offset[i + 1] - offset[i], first_path + i,
+                      dt, theta, mu, sigma, seed, stream);
+    });
 }
@@ -1,11 +1,19 @@
 #ifndef OU_SAMPLER1_HPP
 #define OU_SAMPLER1_HPP
 
+#include "thread_pool.hpp"
+
 #include "hdf5.h"
+#include <cstdint>
 #include <vector>
 
 // Creates `batch_size` sample paths of random length with parameters
 // `dt`, `theta`, `mu`, and `sigma`
+//
+// Path i of the batch is path `first_path + i` of the random stream
+// (`seed`, `stream`); its length and its values depend on nothing else.
+// All lengths are drawn first, so `ou_process` is sized once (and keeps its
+// capacity when reused across batches) and the paths are filled on `pool`.
 extern void ou_sampler1
 (
     std::vector<double>&  ou_process,
@@ -14,7 +22,14 @@ extern void ou_sampler1
     const double&         dt,
     const double&         theta,
     const double&         mu,
-    const double&         sigma
+    const double&         sigma,
+    const uint64_t&       seed,
+    const uint32_t&       stream,
+    const size_t&         first_path,
+    thread_pool&          pool
 );
 
+// The length of path `path` of the random stream (`seed`, `stream`), between 1 and 65535
+extern size_t ou_path_length(const uint64_t& seed, const uint32_t& stream, const size_t& path);
+
 #endif
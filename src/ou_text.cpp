@@ -1,6 +1,6 @@
 #include "ou_sampler.hpp"
+#include "ou_formats.hpp"
 
-#include <fstream>
 #include <iostream>
 #include <vector>
 
@@ -10,32 +10,20 @@ int main()
 {
     const size_t path_count = 100, step_count = 1000;
     const double dt = 0.01, theta = 1.0, mu = 0.0, sigma = 0.1;
+    const uint64_t seed = 0;
+    const uint32_t stream = 0;
 
     cout << "Running with parameters:"
          << " paths=" << path_count << " steps=" << step_count
-         << " dt=" << dt << " theta=" << theta << " mu=" << mu << " sigma=" << sigma << endl;
+         << " dt=" << dt << " theta=" << theta << " mu=" << mu << " sigma=" << sigma
+         << " seed=" << seed << " stream=" << stream << endl;
 
     vector<double> ou_process;
-    ou_sampler(ou_process, path_count, step_count, dt, theta, mu, sigma);
+    ou_sampler(ou_process, path_count, step_count, dt, theta, mu, sigma, seed, stream, 0, 0);
     
     // Write the sample paths to a text file
-    ofstream file("ou_process.txt");
-    
-    file << "# paths steps dt theta mu sigma" << endl;
-    file << path_count << " " << step_count << " " << dt << " " << theta << " " << mu << " " << sigma << endl;
-    file << "# data" << endl;
-    
-    for (size_t i = 0; i < path_count; ++i)
-        {
-            for (size_t j = 0; j < step_count; ++j)
-            {
-                auto pos = i * step_count + j;
-                file << ou_process[pos] << " ";
-            }
-            file << endl;
-        }
-
-    file.close();
+    if (!write_text("ou_process.txt", ou_process, {path_count, step_count, dt, theta, mu, sigma}, 0))
+        return 1;
 
     return 0;
 }
@@ -0,0 +1,147 @@
+#include "docstring.hpp"
+#include "ou_sampler.hpp"
+#include "philox.hpp"
+
+#include "argparse.hpp"
+#include "hdf5.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// The path `path` of (seed, stream), one step at a time with `normal_stream`,
+// as a reference for the vectorized `ou_kernel`
+static void reference_path
+(
+    double*  out,
+    size_t   step_count,
+    uint64_t path,
+    double   dt,
+    double   theta,
+    double   mu,
+    double   sigma,
+    uint64_t seed,
+    uint32_t stream
+)
+{
+    normal_stream z(seed, path, stream);
+    double x = 0.0, sqrt_dt = sqrt(dt);
+    for (size_t j = 0; j < step_count; ++j)
+    {
+        out[j] = x;
+        x = x + theta * (mu - x) * dt + sigma * (sqrt_dt * z());
+    }
+}
+
+// Reads back `/dataset` from an `ou_hdf5` file, regenerates the same paths from
+// the recorded seed and parameters, and checks the error against the recorded
+// bound (which is zero for lossless files)
+//
+// The first regenerated path of every block must also match, bit for bit, a
+// scalar reference, so that a broken kernel cannot pass by regenerating the
+// same wrong paths it wrote.
+int main(int argc, char *argv[])
+{
+    argparse::ArgumentParser program("ou_verify");
+    program.add_argument("file")
+    .help("chooses the file to check")
+    .default_value(string{"ou_process.h5"});
+    program.add_argument("-b", "--block")
+    .help("chooses the number of paths read and compared at a time")
+    .default_value(size_t{1024})
+    .scan<'u', size_t>();
+    program.parse_args(argc, argv);
+
+    auto name = program.get<string>("file");
+    auto block_rows = max<size_t>(1, program.get<size_t>("--block"));
+
+    auto file = H5Fopen(name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (file < 0) {
+        cerr << "Cannot open " << name << endl;
+        return 1;
+    }
+    auto dataset = H5Dopen(file, "/dataset", H5P_DEFAULT);
+    auto space = H5Dget_space(dataset);
+    hsize_t dims[2];
+    H5Sget_simple_extent_dims(space, dims, NULL);
+    size_t path_count = dims[0], step_count = dims[1];
+
+    auto get_attribute = [&](const string& key) {
+        double value = 0.0;
+        if (H5Aexists_by_name(file, "dataset", key.c_str(), H5P_DEFAULT) > 0)
+        {
+            auto attr = H5Aopen_by_name(file, "dataset", key.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+            H5Aread(attr, H5T_NATIVE_DOUBLE, &value);
+            H5Aclose(attr);
+        }
+        return value;
+    };
+    double dt = get_attribute("dt"), theta = get_attribute("θ"), mu = get_attribute("μ"), sigma = get_attribute("σ");
+    double error_bound = get_attribute("error_bound");
+    auto lossy = get_docstring(file, "dataset", "lossy");
+    auto seed_str = get_docstring(file, "dataset", "seed");
+    auto stream_str = get_docstring(file, "dataset", "stream");
+    auto first_path_str = get_docstring(file, "dataset", "first_path");
+    for (auto& [key, value] : {pair<string, string>{"seed", seed_str}, {"stream", stream_str}, {"first_path", first_path_str}})
+        if (value.empty()) {
+            cerr << name << " does not record the " << key << " of its paths" << endl;
+            H5Sclose(space);
+            H5Dclose(dataset);
+            H5Fclose(file);
+            return 1;
+        }
+    uint64_t seed = stoull(seed_str);
+    uint32_t stream = (uint32_t)stoul(stream_str);
+    size_t first_path = stoull(first_path_str);
+    bool relative = lossy.rfind("bitround", 0) == 0;
+
+    cout << "Checking " << path_count << " x " << step_count << " paths (seed=" << seed << " stream=" << stream
+         << " first_path=" << first_path << ")"
+         << (lossy.empty() ? string(" for an exact match") : " against a bound of " + to_string(error_bound) + " (" + lossy + ")")
+         << endl;
+
+    double max_abs = 0.0, max_rel = 0.0;
+    size_t reference_mismatches = 0;
+    vector<double> stored, expected, reference(step_count);
+    for (size_t row = 0; row < path_count; row += block_rows)
+    {
+        hsize_t start[] = {(hsize_t)row, 0};
+        hsize_t count[] = {(hsize_t)min(block_rows, path_count - row), (hsize_t)step_count};
+        stored.resize(count[0] * count[1]);
+        H5Sselect_hyperslab(space, H5S_SELECT_SET, start, NULL, count, NULL);
+        auto mem_space = H5Screate_simple(2, count, NULL);
+        H5Dread(dataset, H5T_NATIVE_DOUBLE, mem_space, space, H5P_DEFAULT, stored.data());
+        H5Sclose(mem_space);
+
+        ou_sampler(expected, count[0], step_count, dt, theta, mu, sigma, seed, stream, first_path + row, 0);
+        reference_path(reference.data(), step_count, first_path + row, dt, theta, mu, sigma, seed, stream);
+        if (!equal(reference.begin(), reference.end(), expected.begin()))
+        {
+            if (reference_mismatches++ == 0)
+                cerr << "Path " << row << " differs from the scalar reference" << endl;
+        }
+
+        for (size_t i = 0; i < stored.size(); ++i)
+        {
+            auto error = fabs(stored[i] - expected[i]);
+            max_abs = max(max_abs, error);
+            if (expected[i] != 0.0)
+                max_rel = max(max_rel, error / fabs(expected[i]));
+            else if (error > 0.0)
+                max_rel = INFINITY;
+        }
+    }
+
+    H5Sclose(space);
+    H5Dclose(dataset);
+    H5Fclose(file);
+
+    bool ok = (relative ? max_rel : max_abs) <= error_bound && reference_mismatches == 0;
+    cout << "max absolute error=" << max_abs << " max relative error=" << max_rel
+         << " reference mismatches=" << reference_mismatches << (ok ? " PASSED" : " FAILED") << endl;
+
+    return ok ? 0 : 1;
+}
@@ -2,6 +2,7 @@
 #include "parse_arguments.hpp"
 #include <cfloat>
 #include <iostream>
+#include <random>
 
 using namespace std;
 
@@ -36,6 +37,20 @@ void set_options(argparse::ArgumentParser& program)
     .help("chooses the volatility of the process")
     .default_value(double{0.1})
     .scan<'f', double>();
+
+    program.add_argument("--seed")
+    .help("chooses the seed of the random number generator (default: random)")
+    .scan<'u', uint64_t>();
+
+    program.add_argument("--stream")
+    .help("chooses the random stream")
+    .default_value(uint32_t{0})
+    .scan<'u', uint32_t>();
+
+    program.add_argument("--first_path")
+    .help("chooses the index in the stream of the first path")
+    .default_value(size_t{0})
+    .scan<'u', size_t>();
 }
 
 int get_arguments
@@ -46,7 +61,10 @@ int get_arguments
     double&                         dt,
     double&                         theta,
     double&                         mu,
-    double&                         sigma
+    double&                         sigma,
+    uint64_t&                       seed,
+    uint32_t&                       stream,
+    size_t&                         first_path
 )
 {
     path_count = program.get<size_t>("--paths");
@@ -76,5 +94,16 @@ int get_arguments
         return -1;
     }
 
+    // Without a seed we pick one; the writers record it so runs can be repeated
+    if (auto given = program.present<uint64_t>("--seed"))
+        seed = *given;
+    else
+    {
+        random_device rd;
+        seed = ((uint64_t)rd() << 32) | rd();
+    }
+    stream = program.get<uint32_t>("--stream");
+    first_path = program.get<size_t>("--first_path");
+
     return 0;
 }
@@ -2,6 +2,7 @@
 #define PARSE_ARGUMENTS_HPP
 
 #include "argparse.hpp"
+#include <cstdint>
 
 // Sets the options for which we are looking
 extern void set_options(argparse::ArgumentParser& program);
@@ -15,7 +16,10 @@ extern int get_arguments
     double&                         dt,
     double&                         theta,
     double&                         mu,
-    double&                         sigma
+    double&                         sigma,
+    uint64_t&                       seed,
+    uint32_t&                       stream,
+    size_t&                         first_path
 );
 
 #endif
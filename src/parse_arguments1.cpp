@@ -1,6 +1,7 @@
 #include "parse_arguments1.hpp"
 #include <cfloat>
 #include <iostream>
+#include <random>
 
 using namespace std;
 
@@ -35,6 +36,20 @@ void set_options1(argparse::ArgumentParser& program)
     .help("chooses the volatility of the process")
     .default_value(double{0.1})
     .scan<'f', double>();
+
+    program.add_argument("--seed")
+    .help("chooses the seed of the random number generator (default: random)")
+    .scan<'u', uint64_t>();
+
+    program.add_argument("--stream")
+    .help("chooses the random stream")
+    .default_value(uint32_t{0})
+    .scan<'u', uint32_t>();
+
+    program.add_argument("--first_path")
+    .help("chooses the index in the stream of the first path")
+    .default_value(size_t{0})
+    .scan<'u', size_t>();
 }
 
 int get_arguments1
@@ -45,7 +60,10 @@ int get_arguments1
     double&                         dt,
     double&                         theta,
     double&                         mu,
-    double&                         sigma
+    double&                         sigma,
+    uint64_t&                       seed,
+    uint32_t&                       stream,
+    size_t&                         first_path
 )
 {
     path_count = program.get<size_t>("--paths");
@@ -75,5 +93,63 @@ int get_arguments1
         return -1;
     }
 
+    // Without a seed we pick one; the writers record it so runs can be repeated
+    if (auto given = program.present<uint64_t>("--seed"))
+        seed = *given;
+    else
+    {
+        random_device rd;
+        seed = ((uint64_t)rd() << 32) | rd();
+    }
+    stream = program.get<uint32_t>("--stream");
+    first_path = program.get<size_t>("--first_path");
+
+    return 0;
+}
+
+void set_storage_options1(argparse::ArgumentParser& program)
+{
+    program.add_argument("--shuffle")
+    .help("shuffles the bytes of each chunk before compression")
+    .default_value(false)
+    .implicit_value(true);
+
+    program.add_argument("--deflate")
+    .help("chooses the gzip compression level, 1-9 (default: no compression)")
+    .default_value(0)
+    .scan<'i', int>();
+
+    program.add_argument("--direct")
+    .help("compresses chunks on worker threads and writes them with H5Dwrite_chunk")
+    .default_value(false)
+    .implicit_value(true);
+
+    program.add_argument("-j", "--threads")
+    .help("chooses the number of sampler and compression threads (0 = one per hardware thread)")
+    .default_value(size_t{0})
+    .scan<'u', size_t>();
+
+    program.add_argument("--buffers")
+    .help("chooses the number of batch buffers shared by the sampler and the writer")
+    .default_value(size_t{2})
+    .scan<'u', size_t>();
+}
+
+int get_storage_options1(const argparse::ArgumentParser& program, storage_options1& options)
+{
+    options.shuffle = program.get<bool>("--shuffle");
+    options.deflate = program.get<int>("--deflate");
+    if (options.deflate < 0 || options.deflate > 9) {
+        cerr << "Deflate level must be between 0 (no compression) and 9" << endl;
+        return -1;
+    }
+    options.direct = program.get<bool>("--direct");
+    options.thread_count = program.get<size_t>("--threads");
+    options.buffer_count = program.get<size_t>("--buffers");
+    if (options.buffer_count < 1) {
+        cerr << "Need at least one batch buffer" << endl;
+        return -1;
+    }
+
     return 0;
 }
@@ -2,6 +2,7 @@
 #define PARSE_ARGUMENTS1_HPP
 
 #include "argparse.hpp"
+#include <cstdint>
 
 // Sets the options for which we are looking
 extern void set_options1(argparse::ArgumentParser& program);
@@ -15,7 +16,26 @@ extern int get_arguments1
     double&                         dt,
     double&                         theta,
     double&                         mu,
-    double&                         sigma
+    double&                         sigma,
+    uint64_t&                       seed,
+    uint32_t&                       stream,
+    size_t&                         first_path
 );
 
+// How `ou_hdf5.1` stores `/paths/data`
+struct storage_options1
+{
+    bool   shuffle;       // byte shuffle before compression
+    int    deflate;       // gzip level 1-9 (0 = no deflate)
+    bool   direct;        // compress chunks on worker threads and write them with H5Dwrite_chunk
+    size_t thread_count;  // sampler and compression threads (0 = one per hardware thread)
+    size_t buffer_count;  // batch buffers shared by the sampler and the writer (2 = double buffering)
+};
+
+// Sets the storage options for which we are looking
+extern void set_storage_options1(argparse::ArgumentParser& program);
+
+// Tests the storage options and retrieves the arguments
+extern int get_storage_options1(const argparse::ArgumentParser& program, storage_options1& options);
+
 #endif
@@ -1,6 +1,7 @@
 #include "parse_arguments2.hpp"
 #include <cfloat>
 #include <iostream>
+#include <random>
 
 using namespace std;
 
@@ -36,7 +37,24 @@ void set_options2(argparse::ArgumentParser& program)
     .default_value(double{0.1})
     .scan<'f', double>();
 
-    program.add_argument("--use_subfiling");
+    program.add_argument("--seed")
+    .help("chooses the seed of the random number generator (default: random)")
+    .scan<'u', uint64_t>();
+
+    program.add_argument("--stream")
+    .help("chooses the random stream")
+    .default_value(uint32_t{0})
+    .scan<'u', uint32_t>();
+
+    program.add_argument("--first_path")
+    .help("chooses the index in the stream of the first path")
+    .default_value(size_t{0})
+    .scan<'u', size_t>();
+
+    program.add_argument("--use_subfiling")
+    .help("writes with the subfiling driver instead of MPI-IO")
+    .default_value(false)
+    .implicit_value(true);
 }
 
 int get_arguments2
@@ -48,6 +66,9 @@ int get_arguments2
     double&                         theta,
     double&                         mu,
     double&                         sigma,
+    uint64_t&                       seed,
+    uint32_t&                       stream,
+    size_t&                         first_path,
     bool&                           use_subfiling
 )
 {
@@ -77,7 +98,18 @@ int get_arguments2
         cerr << "Volatility must be greater than zero" << endl;
         return -1;
     }
-    use_subfiling = program.is_used("--use_subfiling");
+
+    // Without a seed we pick one; the writers record it so runs can be repeated
+    if (auto given = program.present<uint64_t>("--seed"))
+        seed = *given;
+    else
+    {
+        random_device rd;
+        seed = ((uint64_t)rd() << 32) | rd();
+    }
+    stream = program.get<uint32_t>("--stream");
+    first_path = program.get<size_t>("--first_path");
+    use_subfiling = program.get<bool>("--use_subfiling");
 
     return 0;
 }
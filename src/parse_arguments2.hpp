@@ -2,6 +2,7 @@
 #define PARSE_ARGUMENTS2_HPP
 
 #include "argparse.hpp"
+#include <cstdint>
 
 // Sets the options for which we are looking
 extern void set_options2(argparse::ArgumentParser& program);
@@ -16,6 +17,9 @@ extern int get_arguments2
     double&                         theta,
     double&                         mu,
     double&                         sigma,
+    uint64_t&                       seed,
+    uint32_t&                       stream,
+    size_t&                         first_path,
     bool&                           use_subfiling
 );
 
@@ -1,19 +1,146 @@
 #include "partitioner.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+
 using namespace std;
 
-void partition_work(size_t path_count, int rank, int nranks, size_t &start, size_t &stop)
+path_range partition_block(size_t path_count, int rank, int nranks, size_t block)
+{
+  // Divide whole blocks; the remainder goes to the first ranks
+  size_t block_count = (path_count + block - 1) / block;
+  size_t count = block_count / nranks;
+  size_t remainder = block_count % nranks;
+
+  size_t first = rank * count + min((size_t)rank, remainder);
+  size_t last = first + count + ((size_t)rank < remainder ? 1 : 0);
+
+  return {min(first * block, path_count), min(last * block, path_count)};
+}
+
+vector<path_range> partition_block_cyclic(size_t path_count, int rank, int nranks, size_t block)
 {
-  size_t count = path_count / nranks;
-  size_t remainder = path_count % nranks;
+  vector<path_range> ranges;
+  for (size_t first = rank * block; first < path_count; first += nranks * block)
+    ranges.push_back({first, min(first + block, path_count)});
+  return ranges;
+}
+
+path_range partition_weighted(size_t path_count, int rank, const vector<double>& weights, size_t block)
+{
+  // Rank r ends where the running sum of the weights up to r ends, rounded to
+  // the nearest block; all ranks compute the same boundaries
+  size_t block_count = (path_count + block - 1) / block;
+  double total = accumulate(weights.begin(), weights.end(), 0.0);
+  if (!(total > 0.0))
+    return partition_block(path_count, rank, (int)weights.size(), block);
+
+  auto boundary = [&](int r) -> size_t {
+    if (r == (int)weights.size())
+      return block_count;
+    double sum = accumulate(weights.begin(), weights.begin() + r, 0.0);
+    return min(block_count, (size_t)llround(sum / total * block_count));
+  };
 
-  if ((size_t)rank < remainder) {
-    // The first 'remainder' ranks get 'count + 1' tasks each
-    start = rank * (count + 1);
-    stop = start + count;
-  } else {
-    // The remaining 'nranks - remainder' ranks get 'count' task each
-    start = rank * count + remainder;
-    stop = start + (count - 1);
+  return {min(boundary(rank) * block, path_count), min(boundary(rank + 1) * block, path_count)};
+}
+
+void merge_ranges(vector<path_range>& ranges)
+{
+  vector<path_range> merged;
+  for (auto& range : ranges) {
+    if (range.empty())
+      continue;
+    if (!merged.empty() && merged.back().last == range.first)
+      merged.back().last = range.last;
+    else
+      merged.push_back(range);
   }
+  ranges.swap(merged);
+}
+
+size_t chunks_touched(const vector<path_range>& ranges, size_t chunk_rows)
+{
+  // Ranges that end and begin in the same chunk count it once
+  size_t count = 0, last_chunk = SIZE_MAX;
+  for (auto& range : ranges) {
+    if (range.empty())
+      continue;
+    size_t first = range.first / chunk_rows, last = (range.last - 1) / chunk_rows;
+    count += last - first + 1 - (first == last_chunk ? 1 : 0);
+    last_chunk = last;
+  }
+  return count;
+}
+
+vector<size_t> shared_chunks(const vector<path_range>& ranges, size_t path_count, size_t chunk_rows)
+{
+  // A chunk is shared if a range starts or ends inside it (the end of the
+  // dataset is also the end of its last chunk)
+  vector<size_t> chunks;
+  for (auto& range : ranges) {
+    if (range.empty())
+      continue;
+    if (range.first % chunk_rows != 0)
+      chunks.push_back(range.first / chunk_rows);
+    if (range.last % chunk_rows != 0 && range.last != path_count)
+      chunks.push_back(range.last / chunk_rows);
+  }
+  sort(chunks.begin(), chunks.end());
+  chunks.erase(unique(chunks.begin(), chunks.end()), chunks.end());
+  return chunks;
+}
+
+string to_string(partition_scheme scheme)
+{
+  switch (scheme) {
+    case partition_scheme::block:        return "block";
+    case partition_scheme::block_cyclic: return "block-cyclic";
+    case partition_scheme::weighted:     return "weighted";
+  }
+  return "?";
+}
+
+void set_partition_options(argparse::ArgumentParser& program)
+{
+  program.add_argument("--partition")
+  .help("divides the paths among the ranks: block, block-cyclic, or weighted (by measured sampling speed)")
+  .default_value(string{"block"});
+
+  program.add_argument("--partition_block")
+  .help("divides the paths in blocks of this many paths, e.g., the chunk height, so that no two ranks share a chunk")
+  .default_value(size_t{1})
+  .scan<'u', size_t>();
+
+  program.add_argument("--align_chunks")
+  .help("divides whole chunks of a chunked dataset, so that no two ranks write the same chunk")
+  .default_value(false)
+  .implicit_value(true);
+}
+
+int get_partition_options(const argparse::ArgumentParser& program, partition_options& options)
+{
+  auto scheme = program.get<string>("--partition");
+  if (scheme == "block")
+    options.scheme = partition_scheme::block;
+  else if (scheme == "block-cyclic")
+    options.scheme = partition_scheme::block_cyclic;
+  else if (scheme == "weighted")
+    options.scheme = partition_scheme::weighted;
+  else {
+    cerr << "Partition must be block, block-cyclic, or weighted" << endl;
+    return -1;
+  }
+
+  options.block = program.get<size_t>("--partition_block");
+  if (options.block == 0) {
+    cerr << "Partition block must be greater than zero" << endl;
+    return -1;
+  }
+  options.align_chunks = program.get<bool>("--align_chunks");
+
+  return 0;
 }
@@ -1,9 +1,68 @@
-
 #ifndef PARTITIONER_HPP
 #define PARTITIONER_HPP
 
+#include "argparse.hpp"
 #include <cstddef>
+#include <string>
+#include <vector>
+
+// The paths [first, last) of a rank; empty when first == last
+struct path_range
+{
+    std::size_t first;
+    std::size_t last;
+
+    std::size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+};
+
+// How the paths are divided among the ranks
+enum class partition_scheme
+{
+    block,         // one contiguous range per rank, sizes differing by at most one block
+    block_cyclic,  // blocks dealt out round-robin, rank r gets blocks r, r + nranks, ...
+    weighted       // one contiguous range per rank, proportional to the rank's weight
+};
+
+struct partition_options
+{
+    partition_scheme scheme;
+    std::size_t      block;         // the unit of division in paths, e.g., the chunk height
+    bool             align_chunks;  // divide whole chunks, so that every rank owns the chunks it writes
+};
+
+// Divides `path_count` paths into `nranks` contiguous ranges made of whole blocks
+// of `block` paths (only the last block of the file may be shorter)
+//
+// Rank boundaries fall on block boundaries, so no two ranks share a chunk of
+// `block` rows. Ranks without work (e.g., when there are fewer blocks than
+// ranks) get an empty range.
+extern path_range partition_block(std::size_t path_count, int rank, int nranks, std::size_t block = 1);
+
+// Deals the blocks of `block` paths out to the ranks round-robin
+extern std::vector<path_range> partition_block_cyclic(std::size_t path_count, int rank, int nranks, std::size_t block);
+
+// Divides the paths into contiguous ranges of whole blocks in proportion to
+// `weights` (one per rank, e.g., the measured paths per second of each rank)
+extern path_range partition_weighted(std::size_t path_count, int rank, const std::vector<double>& weights, std::size_t block = 1);
+
+// Merges adjacent ranges and drops empty ones
+extern void merge_ranges(std::vector<path_range>& ranges);
+
+// The number of chunks of `chunk_rows` rows that `ranges` touch
+extern std::size_t chunks_touched(const std::vector<path_range>& ranges, std::size_t chunk_rows);
+
+// The chunks of `chunk_rows` rows that `ranges` cover only in part, i.e.,
+// which this rank shares with other ranks, in ascending order
+extern std::vector<std::size_t> shared_chunks(const std::vector<path_range>& ranges, std::size_t path_count, std::size_t chunk_rows);
+
+// Returns the name of a scheme
+extern std::string to_string(partition_scheme scheme);
+
+// Sets the options for which we are looking
+extern void set_partition_options(argparse::ArgumentParser& program);
 
-extern void partition_work(std::size_t path_count, int rank, int nranks, std::size_t &start, std::size_t &stop);
+// Tests the options and retrieves the arguments
+extern int get_partition_options(const argparse::ArgumentParser& program, partition_options& options);
 
 #endif
@@ -0,0 +1,187 @@
+#include "path_reader.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+using namespace std;
+
+path_reader::path_reader(hid_t file, size_t cache_bytes)
+{
+    data_ = H5Dopen(file, "/paths/data", H5P_DEFAULT);
+    auto descr = H5Dopen(file, "/paths/descr", H5P_DEFAULT);
+    if (data_ < 0 || descr < 0)
+        throw runtime_error("not a file of ragged sample paths (no /paths/data and /paths/descr)");
+
+    file_space_ = H5Dget_space(data_);
+    H5Sget_simple_extent_dims(file_space_, &data_size_, NULL);
+
+    // Cache whole chunks (or 1 MiB blocks if the data is contiguous)
+    chunk_size_ = 128 * 1024;
+    auto dcpl = H5Dget_create_plist(data_);
+    if (H5Pget_layout(dcpl) == H5D_CHUNKED)
+        H5Pget_chunk(dcpl, 1, &chunk_size_);
+    H5Pclose(dcpl);
+    max_chunks_ = max<size_t>(2, cache_bytes / (chunk_size_ * sizeof(double)));
+
+    // Path i starts at descr[i] and ends where the next one starts (or the data ends)
+    auto space = H5Dget_space(descr);
+    hsize_t path_count;
+    H5Sget_simple_extent_dims(space, &path_count, NULL);
+    offset_.resize(path_count + 1);
+    if (path_count > 0)
+        H5Dread(descr, H5T_NATIVE_HSIZE, H5S_ALL, H5S_ALL, H5P_DEFAULT, offset_.data());
+    offset_[path_count] = data_size_;
+    H5Sclose(space);
+    H5Dclose(descr);
+}
+
+path_reader::~path_reader()
+{
+    H5Sclose(file_space_);
+    H5Dclose(data_);
+}
+
+path_view path_reader::get_path(size_t i)
+{
+    return fetch({i})[0];
+}
+
+vector<path_view> path_reader::get_paths(size_t first, size_t last)
+{
+    vector<size_t> paths(last > first ? last - first : 0);
+    iota(paths.begin(), paths.end(), first);
+    return fetch(paths);
+}
+
+vector<path_view> path_reader::get_paths(const vector<size_t>& paths)
+{
+    // Paths are stored in order, so sorting them sorts their chunks, too
+    vector<size_t> wanted(paths);
+    sort(wanted.begin(), wanted.end());
+    wanted.erase(unique(wanted.begin(), wanted.end()), wanted.end());
+    auto views = fetch(wanted);
+
+    vector<path_view> result;
+    result.reserve(paths.size());
+    for (auto i : paths)
+        result.push_back(views[lower_bound(wanted.begin(), wanted.end(), i) - wanted.begin()]);
+    return result;
+}
+
+vector<path_view> path_reader::fetch(const vector<size_t>& paths)
+{
+    vector<path_view> views;
+    views.reserve(paths.size());
+
+    // Collect the chunks of the next few paths, load them, and make the views
+    // before a later group can evict them
+    vector<hsize_t> chunks;
+    size_t group = 0;
+    for (size_t k = 0; k <= paths.size(); ++k)
+    {
+        hsize_t first_chunk = 0, last_chunk = 0;
+        if (k < paths.size() && length(paths[k]) > 0)
+        {
+            first_chunk = offset_[paths[k]] / chunk_size_;
+            last_chunk = (offset_[paths[k] + 1] - 1) / chunk_size_ + 1;
+        }
+        auto added = last_chunk - first_chunk;
+        if (added > 0 && !chunks.empty() && chunks.back() >= first_chunk)
+            --added;  // shared with the previous path
+        if (k == paths.size() || (k > group && chunks.size() + added > max_chunks_ / 2))
+        {
+            load(chunks);
+            for (; group < k; ++group)
+                views.push_back(view(paths[group]));
+            chunks.clear();
+        }
+        for (auto c = first_chunk; c < last_chunk; ++c)
+            if (chunks.empty() || chunks.back() < c)
+                chunks.push_back(c);
+    }
+    return views;
+}
+
+void path_reader::load(const vector<hsize_t>& chunks)
+{
+    vector<hsize_t> missing;
+    for (auto c : chunks)
+    {
+        auto it = index_.find(c);
+        if (it == index_.end())
+            missing.push_back(c);
+        else
+            cache_.splice(cache_.begin(), cache_, it->second);
+    }
+
+    // Read every run of adjacent missing chunks with one hyperslab read
+    for (size_t r = 0; r < missing.size();)
+    {
+        auto e = r + 1;
+        while (e < missing.size() && missing[e] == missing[e - 1] + 1)
+            ++e;
+
+        hsize_t first = missing[r] * chunk_size_;
+        hsize_t count = min(data_size_, missing[e - 1] * chunk_size_ + chunk_size_) - first;
+        shared_ptr<double[]> buffer(new double[count]);
+        H5Sselect_hyperslab(file_space_, H5S_SELECT_SET, &first, NULL, &count, NULL);
+        auto mem_space = H5Screate_simple(1, &count, NULL);
+        H5Dread(data_, H5T_NATIVE_DOUBLE, mem_space, file_space_, H5P_DEFAULT, buffer.get());
+        H5Sclose(mem_space);
+        ++read_count_;
+        read_values_ += count;
+
+        // The chunks share the buffer, which lives until the last of them is evicted
+        for (auto k = r; k < e; ++k)
+        {
+            cache_.push_front(cached_chunk{missing[k], shared_ptr<const double>(buffer, buffer.get() + (k - r) * chunk_size_)});
+            index_[missing[k]] = cache_.begin();
+        }
+        r = e;
+    }
+
+    // Evict the least recently used chunks (views keep their own memory alive)
+    while (cache_.size() > max_chunks_)
+    {
+        index_.erase(cache_.back().index);
+        cache_.pop_back();
+    }
+}
+
+path_view path_reader::view(size_t i)
+{
+    path_view v;
+    v.size = length(i);
+    if (v.size == 0)
+        return v;
+
+    auto first = offset_[i], last = offset_[i + 1];
+    auto first_chunk = first / chunk_size_, last_chunk = (last - 1) / chunk_size_;
+    auto& head = index_.at(first_chunk)->values;
+
+    // Chunks read together are contiguous in memory
+    bool contiguous = true;
+    for (auto c = first_chunk + 1; c <= last_chunk && contiguous; ++c)
+    {
+        auto& next = index_.at(c)->values;
+        contiguous = !head.owner_before(next) && !next.owner_before(head);
+    }
+    if (contiguous)
+    {
+        v.data = head.get() + (first - first_chunk * chunk_size_);
+        v.owner = head;
+        return v;
+    }
+
+    auto copy = make_shared<vector<double>>(v.size);
+    for (auto c = first_chunk; c <= last_chunk; ++c)
+    {
+        auto lo = max(first, c * chunk_size_), hi = min(last, (c + 1) * chunk_size_);
+        memcpy(copy->data() + (lo - first), index_.at(c)->values.get() + (lo - c * chunk_size_), (hi - lo) * sizeof(double));
+    }
+    v.data = copy->data();
+    v.owner = copy;
+    return v;
+}
@@ -0,0 +1,91 @@
+#ifndef PATH_READER_HPP
+#define PATH_READER_HPP
+
+#include "hdf5.h"
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// A read-only view of one sample path
+//
+// The view shares ownership of the memory it points to, so it stays valid
+// after the reader has evicted that memory from its cache.
+struct path_view
+{
+    const double*               data = nullptr;
+    size_t                      size = 0;
+    std::shared_ptr<const void> owner;
+
+    const double* begin() const { return data; }
+    const double* end() const { return data + size; }
+    double operator[](size_t i) const { return data[i]; }
+};
+
+// Random access to the sample paths of an `ou_hdf5.1` file
+//
+// The offsets in `/paths/descr` are read once when the reader is created.
+// `/paths/data` is read in whole chunks, which are kept in a least recently
+// used cache of `cache_bytes`. The chunks a request needs and the cache lacks
+// are read with one hyperslab read per run of adjacent chunks, and the views
+// point straight into the buffers of those reads; only a path that straddles
+// two separately read chunks is copied.
+class path_reader
+{
+public:
+    // Reads the index of the paths in `file` (which must stay open)
+    path_reader(hid_t file, size_t cache_bytes = 256 << 20);
+    ~path_reader();
+
+    path_reader(const path_reader&) = delete;
+    path_reader& operator=(const path_reader&) = delete;
+
+    // The number of paths in the file
+    size_t size() const { return offset_.size() - 1; }
+
+    // The number of values in path `i`
+    size_t length(size_t i) const { return offset_[i + 1] - offset_[i]; }
+
+    // Path `i`
+    path_view get_path(size_t i);
+
+    // Paths [first, last)
+    std::vector<path_view> get_paths(size_t first, size_t last);
+
+    // The paths in `paths` (in any order, with repetitions), in the order requested
+    std::vector<path_view> get_paths(const std::vector<size_t>& paths);
+
+    // The number of hyperslab reads and the number of values they returned
+    size_t read_count() const { return read_count_; }
+    size_t read_values() const { return read_values_; }
+
+private:
+    struct cached_chunk
+    {
+        hsize_t                       index;
+        std::shared_ptr<const double> values;  // aliases the buffer of the read
+    };
+
+    // Makes views of `paths` (sorted, no repetitions), in groups small enough to stay cached
+    std::vector<path_view> fetch(const std::vector<size_t>& paths);
+
+    // Brings the chunks `chunks` (sorted, no repetitions) into the cache
+    void load(const std::vector<hsize_t>& chunks);
+
+    // A view of path `i`, whose chunks must be cached
+    path_view view(size_t i);
+
+    hid_t                 data_;
+    hid_t                 file_space_;
+    hsize_t               data_size_;
+    hsize_t               chunk_size_;
+    std::vector<hsize_t>  offset_;      // path i is [offset_[i], offset_[i + 1])
+    size_t                max_chunks_;  // capacity of the cache
+    std::list<cached_chunk> cache_;     // most recently used first
+    std::unordered_map<hsize_t, std::list<cached_chunk>::iterator> index_;
+    size_t                read_count_ = 0;
+    size_t                read_values_ = 0;
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef PHILOX_HPP
+#define PHILOX_HPP
+
+#include "ou_math.hpp"
+
+#include <array>
+#include <cstdint>
+
+// Philox4x32-10 counter-based random number generator (Salmon et al., SC'11)
+//
+// The output is a pure function of a 128-bit counter and a 64-bit key, so any
+// element of any stream can be computed without generating the ones before it.
+// We use the key for the seed and the counter for (step, path, stream), which
+// gives every sample path its own independent stream.
+
+typedef std::array<uint32_t, 4> philox_ctr;
+typedef std::array<uint32_t, 2> philox_key;
+
+inline philox_ctr philox4x32(philox_ctr ctr, philox_key key)
+{
+    const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;  // multipliers
+    const uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;  // Weyl sequence key increments
+
+    for (int round = 0; round < 10; ++round)
+    {
+        if (round > 0)
+        {
+            key[0] += W0;
+            key[1] += W1;
+        }
+        uint64_t p0 = (uint64_t)M0 * ctr[0], p1 = (uint64_t)M1 * ctr[2];
+        ctr = {(uint32_t)(p1 >> 32) ^ ctr[1] ^ key[0], (uint32_t)p1,
+               (uint32_t)(p0 >> 32) ^ ctr[3] ^ key[1], (uint32_t)p0};
+    }
+    return ctr;
+}
+
+// Maps two 32-bit words onto a double in [0, 1) with 53 random bits
+inline double philox_uniform(uint32_t hi, uint32_t lo)
+{
+    return (double)((((uint64_t)hi << 32) | lo) >> 11) * 0x1.0p-53;
+}
+
+// Draws N(0, 1) variates for one sample path
+//
+// Each call to the generator yields two uniforms, which Box-Muller turns into
+// two normal variates. The sequence is determined by (seed, path, stream) only
+// and is, bit for bit, the increments `ou_kernel` draws for the same path, one
+// variate at a time; `ou_verify` uses it to check the kernel independently.
+class normal_stream
+{
+public:
+    normal_stream(uint64_t seed, uint64_t path, uint32_t stream)
+    : key_{(uint32_t)seed, (uint32_t)(seed >> 32)},
+      ctr_{0, (uint32_t)path, (uint32_t)(path >> 32), stream}
+    {
+    }
+
+    double operator()()
+    {
+        if (have_spare_)
+        {
+            have_spare_ = false;
+            return spare_;
+        }
+        auto r = philox4x32(ctr_, key_);
+        ++ctr_[0];
+
+        // u1 is in (0, 1] so that the logarithm is finite
+        auto u1 = 1.0 - philox_uniform(r[0], r[1]), u2 = philox_uniform(r[2], r[3]);
+        double z0, z1;
+        box_muller<scalar_isa>(u1, u2, z0, z1);
+
+        spare_ = z1;
+        have_spare_ = true;
+        return z0;
+    }
+
+private:
+    philox_key key_;
+    philox_ctr ctr_;
+    double     spare_ = 0.0;
+    bool       have_spare_ = false;
+};
+
+#endif
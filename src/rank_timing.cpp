@@ -0,0 +1,88 @@
+#include "rank_timing.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+rank_timing::rank_timing(MPI_Comm comm)
+: comm_(comm), last_(MPI_Wtime())
+{
+}
+
+void rank_timing::stop(const string& phase)
+{
+    auto now = MPI_Wtime();
+    phases_.push_back(phase);
+    seconds_.push_back(now - last_);
+    last_ = now;
+}
+
+void rank_timing::report(double bytes, const string& io_phase, bool per_rank, bool histogram) const
+{
+    int rank, nranks;
+    MPI_Comm_rank(comm_, &rank);
+    MPI_Comm_size(comm_, &nranks);
+
+    // One row per rank: the phase times and the bytes
+    vector<double> row(seconds_);
+    row.push_back(bytes);
+    vector<double> all(rank == 0 ? row.size() * nranks : 0);
+    MPI_Gather(row.data(), (int)row.size(), MPI_DOUBLE, all.data(), (int)row.size(), MPI_DOUBLE, 0, comm_);
+    if (rank != 0)
+        return;
+
+    auto width = row.size();
+    if (per_rank)
+    {
+        printf("%6s", "rank");
+        for (auto& phase : phases_)
+            printf(" %12s", (phase + " s").c_str());
+        printf(" %12s\n", "MiB");
+        for (int r = 0; r < nranks; ++r)
+        {
+            printf("%6d", r);
+            for (size_t p = 0; p < phases_.size(); ++p)
+                printf(" %12.6f", all[r * width + p]);
+            printf(" %12.2f\n", all[r * width + phases_.size()] / (1 << 20));
+        }
+    }
+
+    double total_bytes = 0.0;
+    for (int r = 0; r < nranks; ++r)
+        total_bytes += all[r * width + phases_.size()];
+
+    for (size_t p = 0; p < phases_.size(); ++p)
+    {
+        double lo = all[p], hi = all[p], sum = 0.0;
+        for (int r = 0; r < nranks; ++r)
+        {
+            auto t = all[r * width + p];
+            lo = min(lo, t);
+            hi = max(hi, t);
+            sum += t;
+        }
+        printf("%-8s min %.6f s, mean %.6f s, max %.6f s", phases_[p].c_str(), lo, sum / nranks, hi);
+        // the slowest rank determines the time of a collective operation
+        if (phases_[p] == io_phase && hi > 0.0)
+            printf(", %.1f MiB/s aggregate", total_bytes / (1 << 20) / hi);
+        printf("\n");
+
+        // Up to 10 equal bins between the fastest and the slowest rank; one
+        // tall bar means the ranks are balanced, a tail means stragglers
+        if (histogram && nranks > 1 && hi > lo)
+        {
+            size_t bins = min(10, nranks);
+            vector<int> count(bins, 0);
+            for (int r = 0; r < nranks; ++r)
+                ++count[min(bins - 1, (size_t)((all[r * width + p] - lo) / (hi - lo) * bins))];
+            int most = *max_element(count.begin(), count.end());
+            for (size_t b = 0; b < bins; ++b)
+            {
+                double from = lo + (hi - lo) * b / bins, to = lo + (hi - lo) * (b + 1) / bins;
+                printf("  %10.6f - %10.6f s %6d |%s\n", from, to, count[b], string(40 * count[b] / most, '#').c_str());
+            }
+        }
+    }
+    fflush(stdout);
+}
@@ -0,0 +1,35 @@
+#ifndef RANK_TIMING_HPP
+#define RANK_TIMING_HPP
+
+#include <mpi.h>
+#include <string>
+#include <vector>
+
+// Collects the time each rank spends in the phases of a run and reports them on rank 0
+//
+// Every rank calls `stop` in the same order with the same phase names;
+// `report` is collective and prints, for each phase, the minimum, mean, and
+// maximum over the ranks (and, with `per_rank`, every rank's times; with
+// `histogram`, how the ranks' times are distributed). The spread between the
+// slowest and the fastest rank shows load imbalance and contention, which the
+// mean hides.
+class rank_timing
+{
+public:
+    explicit rank_timing(MPI_Comm comm);
+
+    // Ends the current phase (which began at construction or at the previous `stop`)
+    void stop(const std::string& phase);
+
+    // Gathers the times and prints them on rank 0; `bytes` is this rank's share
+    // of the data, which gives the bandwidth of the phase called `io_phase`
+    void report(double bytes, const std::string& io_phase, bool per_rank, bool histogram = false) const;
+
+private:
+    MPI_Comm                 comm_;
+    double                   last_;
+    std::vector<std::string> phases_;
+    std::vector<double>      seconds_;
+};
+
+#endif
@@ -0,0 +1,143 @@
+#include "read_planner.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <future>
+
+using namespace std;
+
+static void sort_selections(vector<row_selection>& selections)
+{
+    selections.erase(remove_if(selections.begin(), selections.end(),
+                               [](const row_selection& s) { return s.first >= s.last; }),
+                     selections.end());
+    sort(selections.begin(), selections.end(),
+         [](const row_selection& a, const row_selection& b) { return a.first < b.first; });
+}
+
+vector<row_range> plan_reads
+(
+    vector<row_selection>    selections,
+    const size_t&            cols,
+    const read_plan_options& options
+)
+{
+    sort_selections(selections);
+
+    // the rows of one request, in whole chunks: rounded down, or up to one
+    // chunk when the limit is smaller, so that every split is on a boundary
+    auto max_rows = max<size_t>(1, options.max_request_bytes / max<size_t>(1, cols * sizeof(double)));
+    if (options.chunk_rows > 0)
+        max_rows = max(options.chunk_rows, max_rows - max_rows % options.chunk_rows);
+
+    vector<row_range> runs;
+    for (auto& s : selections)
+    {
+        if (!runs.empty() && s.first <= runs.back().last + options.merge_gap)
+            runs.back().last = max(runs.back().last, s.last);
+        else
+            runs.push_back({s.first, s.last});
+    }
+
+    vector<row_range> requests;
+    for (auto& run : runs)
+    {
+        for (auto first = run.first; first < run.last;)
+        {
+            auto last = first + max_rows;
+            if (options.chunk_rows > 0 && last - last % options.chunk_rows > first)
+                last -= last % options.chunk_rows;
+            last = min(last, run.last);
+            requests.push_back({first, last});
+            first = last;
+        }
+    }
+    return requests;
+}
+
+read_planner::read_planner(const string& endpoint, const read_plan_options& options)
+: options_(options), pool_(max<size_t>(1, options.connections))
+{
+    for (size_t i = 0; i < pool_.size(); ++i)
+        clients_.push_back(make_unique<hsds_client>(endpoint));
+}
+
+rest_stats read_planner::read
+(
+    const string&                domain,
+    const string&                id,
+    const size_t&                cols,
+    const vector<row_selection>& selections
+)
+{
+    auto sorted = selections;
+    sort_selections(sorted);
+    auto requests = plan_reads(sorted, cols, options_);
+
+    // the largest `last` up to each selection, to find the selections that
+    // overlap a request by bisection even if selections nest
+    vector<size_t> max_last(sorted.size());
+    for (size_t i = 0; i < sorted.size(); ++i)
+        max_last[i] = max(i == 0 ? 0 : max_last[i - 1], sorted[i].last);
+
+    auto row_bytes = cols * sizeof(double);
+    auto fetch = [&](hsds_client& client, const row_range& r) {
+        auto begin = upper_bound(max_last.begin(), max_last.end(), r.first) - max_last.begin();
+        auto end = lower_bound(sorted.begin() + begin, sorted.end(), r.last,
+                               [](const row_selection& s, size_t row) { return s.first < row; }) - sorted.begin();
+
+        for (auto i = begin; i < end; ++i)
+            if (sorted[i].first <= r.first && sorted[i].last >= r.last)
+            {
+                client.read_rows(domain, id, r.first, r.last, cols, sorted[i].data + (r.first - sorted[i].first) * cols);
+                // other selections of the same rows still need their copy
+                for (auto j = begin; j < end; ++j)
+                    if (j != i)
+                    {
+                        auto first = max(r.first, sorted[j].first), last = min(r.last, sorted[j].last);
+                        if (first < last)
+                            memcpy(sorted[j].data + (first - sorted[j].first) * cols,
+                                   sorted[i].data + (first - sorted[i].first) * cols, (last - first) * row_bytes);
+                    }
+                return;
+            }
+
+        vector<double> buffer((r.last - r.first) * cols);
+        client.read_rows(domain, id, r.first, r.last, cols, buffer.data());
+        for (auto i = begin; i < end; ++i)
+        {
+            auto first = max(r.first, sorted[i].first), last = min(r.last, sorted[i].last);
+            if (first < last)
+                memcpy(sorted[i].data + (first - sorted[i].first) * cols,
+                       &buffer[(first - r.first) * cols], (last - first) * row_bytes);
+        }
+    };
+
+    // one worker per connection takes the next request until none are left
+    vector<rest_stats> before;
+    for (auto& client : clients_)
+        before.push_back(client->stats());
+    atomic<size_t> next(0);
+    vector<future<void>> workers;
+    for (auto& client : clients_)
+        workers.push_back(pool_.submit([&, c = client.get()] {
+            for (size_t i; (i = next++) < requests.size();)
+                fetch(*c, requests[i]);
+        }));
+    for (auto& w : workers)
+        w.wait();
+    for (auto& w : workers)
+        w.get();
+
+    rest_stats stats;
+    for (size_t i = 0; i < clients_.size(); ++i)
+    {
+        auto& s = clients_[i]->stats();
+        stats.requests += s.requests - before[i].requests;
+        stats.bytes_sent += s.bytes_sent - before[i].bytes_sent;
+        stats.bytes_received += s.bytes_received - before[i].bytes_received;
+        stats.latencies.insert(stats.latencies.end(), s.latencies.begin() + before[i].latencies.size(), s.latencies.end());
+    }
+    return stats;
+}
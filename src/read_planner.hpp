@@ -0,0 +1,80 @@
+#ifndef READ_PLANNER_HPP
+#define READ_PLANNER_HPP
+
+#include "hsds_client.hpp"
+#include "thread_pool.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Rows [first, last) of a 2-D dataset, to be read into `data` (row-major)
+struct row_selection
+{
+    std::size_t first;
+    std::size_t last;
+    double*     data;
+};
+
+// Rows [first, last) fetched by one request
+struct row_range
+{
+    std::size_t first;
+    std::size_t last;
+};
+
+// How `read_planner` turns selections into requests
+struct read_plan_options
+{
+    std::size_t chunk_rows = 0;                // rows per chunk of the dataset (0 = split anywhere)
+    std::size_t max_request_bytes = 4 << 20;   // the most one request reads (at least one chunk or row)
+    std::size_t merge_gap = 0;                 // merges selections up to this many rows apart, reading the gap
+    std::size_t connections = 4;               // concurrent requests
+};
+
+// The requests for reading `selections` of a dataset with `cols` columns
+//
+// Selections that overlap or are at most `merge_gap` rows apart are merged
+// into runs, and each run is split into requests of at most
+// `max_request_bytes`, rounded down to whole chunks (but never less than one
+// chunk). All requests but the first of a run start on a chunk boundary, so
+// that requests read whole chunks and no chunk is fetched twice.
+// The requests are sorted by row.
+extern std::vector<row_range> plan_reads
+(
+    std::vector<row_selection> selections,
+    const std::size_t&         cols,
+    const read_plan_options&   options
+);
+
+// Reads selections of datasets over a fixed pool of HSDS connections
+//
+// `read` plans the requests with `plan_reads` and issues them concurrently,
+// one worker per connection; the connections stay open between calls. A
+// request that one selection covers is read in place, others through a
+// buffer that is scattered to the selections.
+class read_planner
+{
+public:
+    read_planner(const std::string& endpoint, const read_plan_options& options);
+
+    read_planner(const read_planner&) = delete;
+    read_planner& operator=(const read_planner&) = delete;
+
+    // Reads `selections` of dataset `id` (`cols` columns) of `domain` and
+    // returns what the requests of this call cost
+    rest_stats read
+    (
+        const std::string&                domain,
+        const std::string&                id,
+        const std::size_t&                cols,
+        const std::vector<row_selection>& selections
+    );
+
+private:
+    read_plan_options                         options_;
+    std::vector<std::unique_ptr<hsds_client>> clients_;
+    thread_pool                               pool_;
+};
+
+#endif
@@ -14,8 +14,10 @@ int main(void)
     H5Pset_fapl_rest_vol(fapl);
 
     LOG("Creating file...")
+    char file_name[FILENAME_BUFFER_SIZE];
+    hsds_filename(file_name, FILENAME_BUFFER_SIZE, "my_file.h5");
     hid_t file = H5I_INVALID_HID;
-    if ((file = H5Fcreate(HSDS_FILENAME_PREFIX "my_file.h5", H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0)
+    if ((file = H5Fcreate(file_name, H5F_ACC_TRUNC, H5P_DEFAULT, fapl)) < 0)
     {
         ERROR("Failed to create file");
     }
@@ -1,6 +1,11 @@
 #ifndef RESTVOL_H
 #define RESTVOL_H
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The HSDS folder for the files if none of OU_HSDS_PREFIX, HSDS_USERNAME, and HS_USERNAME is set
 #define HSDS_FILENAME_PREFIX "/home/vscode/"
 
 #define FILENAME_BUFFER_SIZE 1024
@@ -14,6 +19,23 @@
 #define LOG(msg) \
     fprintf(stderr, "%s\n", msg);
 
+// Writes the HSDS path of `name` to `buf`: in the folder $OU_HSDS_PREFIX if it
+// is set, else in /home/$HSDS_USERNAME/ or /home/$HS_USERNAME/, else in
+// HSDS_FILENAME_PREFIX (the same rule as `hsds_domain` in hsds_domain.hpp)
+static inline void hsds_filename(char *buf, size_t size, const char *name)
+{
+    const char *prefix = getenv("OU_HSDS_PREFIX");
+    const char *user = getenv("HSDS_USERNAME");
+    if (user == NULL || *user == '\0')
+        user = getenv("HS_USERNAME");
+    if (prefix != NULL && *prefix != '\0')
+        snprintf(buf, size, "%s%s%s", prefix, prefix[strlen(prefix) - 1] == '/' ? "" : "/", name);
+    else if (user != NULL && *user != '\0')
+        snprintf(buf, size, "/home/%s/%s", user, name);
+    else
+        snprintf(buf, size, "%s%s", HSDS_FILENAME_PREFIX, name);
+}
+
 // For displaying log messages after the progress bars for dataset read/write
 #define SCROLL_AMNT (NUM_DATASETS < 21 ? NUM_DATASETS : 21)
 
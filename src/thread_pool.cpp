@@ -0,0 +1,77 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+using namespace std;
+
+thread_pool::thread_pool(size_t thread_count)
+{
+    if (thread_count == 0)
+        thread_count = max(1u, thread::hardware_concurrency());
+
+    for (size_t i = 0; i < thread_count; ++i)
+        workers_.emplace_back([this] { run(); });
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        lock_guard<mutex> lock(mutex_);
+        stop_ = true;
+    }
+    ready_.notify_all();
+    for (auto& worker : workers_)
+        worker.join();
+}
+
+future<void> thread_pool::submit(function<void()> task)
+{
+    packaged_task<void()> job(move(task));
+    auto result = job.get_future();
+    {
+        lock_guard<mutex> lock(mutex_);
+        tasks_.push_back(move(job));
+    }
+    ready_.notify_one();
+    return result;
+}
+
+void thread_pool::parallel_for(size_t count, size_t grain, const function<void(size_t, size_t)>& body)
+{
+    if (count == 0)
+        return;
+    grain = max<size_t>(grain, 1);
+    auto block_count = (count + grain - 1) / grain;
+
+    // Every worker pulls the next block until there are none left, which
+    // balances the load when blocks take different amounts of time
+    atomic<size_t> next{0};
+    auto worker = [&] {
+        for (auto b = next++; b < block_count; b = next++)
+            body(b * grain, min(count, (b + 1) * grain));
+    };
+
+    vector<future<void>> done;
+    for (size_t i = 0; i < min(size(), block_count); ++i)
+        done.push_back(submit(worker));
+    for (auto& f : done)
+        f.get();  // rethrows exceptions from `body`
+}
+
+void thread_pool::run()
+{
+    for (;;)
+    {
+        packaged_task<void()> job;
+        {
+            unique_lock<mutex> lock(mutex_);
+            ready_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+            if (stop_ && tasks_.empty())
+                return;
+            job = move(tasks_.front());
+            tasks_.pop_front();
+        }
+        job();
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads that run queued tasks
+class thread_pool
+{
+public:
+    // Starts `thread_count` workers (0 = one per hardware thread)
+    explicit thread_pool(std::size_t thread_count);
+    ~thread_pool();
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    std::size_t size() const { return workers_.size(); }
+
+    // Queues `task` and returns a future that becomes ready when it has run
+    std::future<void> submit(std::function<void()> task);
+
+    // Calls `body(first, last)` for consecutive blocks of at most `grain`
+    // indices covering [0, count) and returns when all blocks are done
+    void parallel_for
+    (
+        std::size_t                                        count,
+        std::size_t                                        grain,
+        const std::function<void(std::size_t, std::size_t)>& body
+    );
+
+private:
+    void run();
+
+    std::vector<std::thread>                  workers_;
+    std::deque<std::packaged_task<void()>>    tasks_;
+    std::mutex                                mutex_;
+    std::condition_variable                   ready_;
+    bool                                      stop_ = false;
+};
+
+#endif
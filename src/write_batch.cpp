@@ -0,0 +1,50 @@
+#include "write_batch.hpp"
+
+using namespace std;
+
+write_batch::~write_batch()
+{
+    clear();
+}
+
+void write_batch::add(hid_t dataset, hid_t mem_type, hid_t mem_space, hid_t file_space, const void* buf)
+{
+    datasets_.push_back(dataset);
+    mem_types_.push_back(mem_type);
+    // H5S_ALL is not a dataspace and needs no copy
+    mem_spaces_.push_back(mem_space == H5S_ALL ? H5S_ALL : H5Scopy(mem_space));
+    file_spaces_.push_back(file_space == H5S_ALL ? H5S_ALL : H5Scopy(file_space));
+    bufs_.push_back(buf);
+}
+
+herr_t write_batch::flush(hid_t dxpl)
+{
+    herr_t status = 0;
+    if (datasets_.empty())
+        return status;
+
+#if H5_VERSION_GE(1, 14, 0)
+    status = H5Dwrite_multi(datasets_.size(), datasets_.data(), mem_types_.data(), mem_spaces_.data(),
+                            file_spaces_.data(), dxpl, bufs_.data());
+#else
+    for (size_t i = 0; i < datasets_.size() && status >= 0; ++i)
+        status = H5Dwrite(datasets_[i], mem_types_[i], mem_spaces_[i], file_spaces_[i], dxpl, bufs_[i]);
+#endif
+
+    clear();
+    return status;
+}
+
+void write_batch::clear()
+{
+    for (auto* spaces : {&mem_spaces_, &file_spaces_})
+        for (auto space : *spaces)
+            if (space != H5S_ALL)
+                H5Sclose(space);
+
+    datasets_.clear();
+    mem_types_.clear();
+    mem_spaces_.clear();
+    file_spaces_.clear();
+    bufs_.clear();
+}
@@ -0,0 +1,43 @@
+#ifndef WRITE_BATCH_HPP
+#define WRITE_BATCH_HPP
+
+#include "hdf5.h"
+#include <vector>
+
+// Collects writes to one or more datasets and issues them together
+//
+// With HDF5 1.14 or later, `flush` passes all writes to one H5Dwrite_multi,
+// which the native VOL carries out in one pass (one collective operation with
+// the MPI-IO driver) and the REST VOL in one request; older libraries get one
+// H5Dwrite per write. The buffers must stay valid until `flush` returns.
+class write_batch
+{
+public:
+    write_batch() = default;
+    ~write_batch();
+
+    write_batch(const write_batch&) = delete;
+    write_batch& operator=(const write_batch&) = delete;
+
+    // Queues writing `buf` (of type `mem_type`, laid out as `mem_space`) to the
+    // selection `file_space` of `dataset`; the batch keeps copies of the
+    // dataspaces, so the caller may change or close them right away
+    void add(hid_t dataset, hid_t mem_type, hid_t mem_space, hid_t file_space, const void* buf);
+
+    // Writes everything queued and empties the batch
+    herr_t flush(hid_t dxpl = H5P_DEFAULT);
+
+    // The number of queued writes
+    std::size_t size() const { return datasets_.size(); }
+
+private:
+    void clear();
+
+    std::vector<hid_t>       datasets_;
+    std::vector<hid_t>       mem_types_;
+    std::vector<hid_t>       mem_spaces_;
+    std::vector<hid_t>       file_spaces_;
+    std::vector<const void*> bufs_;
+};
+
+#endif